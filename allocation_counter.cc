@@ -0,0 +1,92 @@
+#include "allocation_counter.h"
+#include <cstdlib>
+#include <new>
+
+
+namespace
+{
+
+
+	constinit thread_local AllocationCounters counters;
+
+	// the size of every allocation is stored in front of it, so the unsized
+	// operator delete can still count the bytes that are released
+	constexpr auto header_size = std::size_t{__STDCPP_DEFAULT_NEW_ALIGNMENT__};
+
+
+	void count_allocation(std::size_t size)
+	{
+		++counters.allocations;
+		counters.bytes += size;
+		counters.live_bytes += size;
+		counters.peak_live_bytes = std::max(counters.peak_live_bytes, counters.live_bytes);
+	}
+
+
+	void* allocate(std::size_t size, std::size_t alignment) noexcept
+	{
+		const auto offset = std::max(header_size, alignment);
+		auto* const base = static_cast<char*>(
+			alignment <= header_size
+				? std::malloc(size + offset)
+				: std::aligned_alloc(alignment, (size + offset + alignment - 1) / alignment * alignment));
+		if (base == nullptr)
+			return nullptr;
+		count_allocation(size);
+		auto* const result = base + offset;
+		*reinterpret_cast<std::size_t*>(result - sizeof(std::size_t)) = size;
+		return result;
+	}
+
+
+	void* allocate_or_throw(std::size_t size, std::size_t alignment)
+	{
+		while (true)
+		{
+			if (auto* const result = allocate(size, alignment))
+				return result;
+			if (const auto handler = std::get_new_handler())
+				handler();
+			else
+				throw std::bad_alloc{};
+		}
+	}
+
+
+	void deallocate(void* pointer, std::size_t alignment) noexcept
+	{
+		if (pointer == nullptr)
+			return;
+		auto* const result = static_cast<char*>(pointer);
+		counters.live_bytes -= *reinterpret_cast<std::size_t*>(result - sizeof(std::size_t));
+		std::free(result - std::max(header_size, alignment));
+	}
+
+
+}
+
+
+AllocationCounters& allocation_counters() { return counters; }
+
+
+void* operator new  (std::size_t size) { return allocate_or_throw(size, header_size); }
+void* operator new[](std::size_t size) { return allocate_or_throw(size, header_size); }
+void* operator new  (std::size_t size, std::align_val_t alignment) { return allocate_or_throw(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocate_or_throw(size, static_cast<std::size_t>(alignment)); }
+void* operator new  (std::size_t size, const std::nothrow_t&) noexcept { return allocate(size, header_size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size, header_size); }
+void* operator new  (std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocate(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocate(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete  (void* pointer) noexcept { deallocate(pointer, header_size); }
+void operator delete[](void* pointer) noexcept { deallocate(pointer, header_size); }
+void operator delete  (void* pointer, std::size_t) noexcept { deallocate(pointer, header_size); }
+void operator delete[](void* pointer, std::size_t) noexcept { deallocate(pointer, header_size); }
+void operator delete  (void* pointer, std::align_val_t alignment) noexcept { deallocate(pointer, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept { deallocate(pointer, static_cast<std::size_t>(alignment)); }
+void operator delete  (void* pointer, std::size_t, std::align_val_t alignment) noexcept { deallocate(pointer, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t alignment) noexcept { deallocate(pointer, static_cast<std::size_t>(alignment)); }
+void operator delete  (void* pointer, const std::nothrow_t&) noexcept { deallocate(pointer, header_size); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { deallocate(pointer, header_size); }
+void operator delete  (void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept { deallocate(pointer, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept { deallocate(pointer, static_cast<std::size_t>(alignment)); }
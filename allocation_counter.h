@@ -0,0 +1,48 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+
+
+// Counted by the replacements of the global operator new and delete in
+// allocation_counter.cc, per thread.
+struct AllocationCounters
+{
+	std::int64_t allocations = 0;
+	std::int64_t bytes = 0;
+	std::int64_t live_bytes = 0;
+	std::int64_t peak_live_bytes = 0;
+};
+
+AllocationCounters& allocation_counters();
+
+
+// Counts the allocations done by this thread during its lifetime. Peak live
+// bytes only include memory allocated during that time.
+class AllocationScope
+{
+public:
+	explicit AllocationScope() :
+		start(allocation_counters())
+	{
+		allocation_counters().peak_live_bytes = start.live_bytes;
+	}
+
+	~AllocationScope()
+	{
+		auto& counters = allocation_counters();
+		counters.peak_live_bytes = std::max(start.peak_live_bytes, counters.peak_live_bytes);
+	}
+
+	AllocationCounters get() const
+	{
+		const auto& counters = allocation_counters();
+		return AllocationCounters{
+			counters.allocations - start.allocations,
+			counters.bytes - start.bytes,
+			counters.live_bytes - start.live_bytes,
+			counters.peak_live_bytes - start.live_bytes};
+	}
+
+private:
+	AllocationCounters start;
+};
@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <spanstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+#include "benchmark.h"
+#include "mapped_file.h"
+#include "src/kernel_benchmark.h"
+#include "src/registry.h"
+#include "src/util.h"
+
+
+// Microbenchmarks of whole solvers and of the kernels they register (see
+// src/kernel_benchmark.h), built separately from the answer checker so it
+// can use other compiler flags.
+//
+//   AoC2021_bench [--warmup N] [--bench-time MS] [filter...]
+//
+// Only benchmarks with a name matching or containing one of the filters are
+// run, filters may contain wildcards like the ones of the test runner.
+
+
+namespace
+{
+
+
+	auto measure(auto&& func)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		func();
+		return std::chrono::steady_clock::now() - start;
+	}
+
+
+	// times a solver on its real input, preloaded into memory
+	void run_solver(const Solver& solver, const BenchmarkSettings& settings)
+	{
+		for (const auto& test: solver.tests)
+		{
+			if (test.expected)
+				continue;
+			const auto input = MappedFile("input" / std::filesystem::path{test.input});
+			const auto stats = benchmark(settings, [&]
+			{
+				auto is = std::ispanstream{std::span{input.view()}};
+				const auto arena_scope = ArenaScope{};
+				return measure([&] { std::visit([&](auto func) { do_not_optimize(func(is)); }, solver.function); });
+			});
+			std::cout << "Solver " << std::setw(24) << std::left << solver.name << std::right << stats << std::endl;
+		}
+	}
+
+
+	// Kernels are often much faster than the resolution of the clock, so
+	// they are called in batches of at least 10 us and the statistics of the
+	// batches are divided by the number of operations in a batch.
+	void run_kernel(const KernelBenchmark& kernel_benchmark, const BenchmarkSettings& settings)
+	{
+		auto input_file = std::ifstream("input" / std::filesystem::path{kernel_benchmark.input});
+		if (!input_file.good())
+			throw std::runtime_error("Could not find " + kernel_benchmark.input);
+		auto kernel = kernel_benchmark.set_up(input_file);
+		// cold caches would make the batches too small
+		for (auto i = 0; i < settings.warmup; ++i)
+			kernel();
+		auto batch_size = 1;
+		auto operations_per_batch = 0;
+		while (true)
+		{
+			operations_per_batch = 0;
+			const auto duration = measure([&]
+			{
+				for (auto i = 0; i < batch_size; ++i)
+					operations_per_batch += kernel();
+			});
+			using namespace std::literals;
+			if (duration >= 10us)
+				break;
+			batch_size *= 2;
+		}
+		const auto stats = benchmark(settings, [&]
+		{
+			return measure([&]
+			{
+				for (auto i = 0; i < batch_size; ++i)
+					kernel();
+			});
+		});
+		const auto ns = [&](Statistics::Duration duration) { return 1000 * duration.count() / operations_per_batch; };
+		const auto flags = std::cout.flags();
+		std::cout << "Kernel " << std::setw(24) << std::left << kernel_benchmark.name << std::right
+		          << std::fixed << std::setprecision(1)
+		          << "min " << std::setw(10) << ns(stats.min)
+		          << ", median " << std::setw(10) << ns(stats.median)
+		          << ", p90 " << std::setw(10) << ns(stats.p90)
+		          << " ns/op (" << stats.repetitions << " x " << operations_per_batch << " ops)" << std::endl;
+		std::cout.flags(flags);
+	}
+
+
+}
+
+
+int main(int argc, char** argv)
+{
+	auto settings = BenchmarkSettings{};
+	auto filters = std::vector<std::string_view>{};
+	for (int i = 1; i < argc; ++i)
+	{
+		const auto arg = std::string_view{argv[i]};
+		auto value = [&]
+		{
+			if (++i == argc)
+				throw std::runtime_error("Missing value for " + std::string{arg});
+			return std::string{argv[i]};
+		};
+		if (arg == "--warmup")
+			settings.warmup = std::stoi(value());
+		else if (arg == "--bench-time")
+			settings.target_time = std::chrono::milliseconds{std::stoi(value())};
+		else if (arg.starts_with("--"))
+			throw std::runtime_error("Unknown option " + std::string{arg});
+		else
+			filters.push_back(arg);
+	}
+	auto selected = [&](std::string_view name)
+	{
+		return filters.empty() || std::ranges::any_of(filters, [&](auto filter)
+		{
+			return glob_match(filter, name) || name.find(filter) != name.npos;
+		});
+	};
+	for (const auto& [name, solver]: registered_solvers())
+		if (selected(name))
+			run_solver(solver, settings);
+	for (const auto& kernel: kernel_benchmarks())
+		if (selected(kernel.name) || selected(kernel.input))
+			run_kernel(kernel, settings);
+}
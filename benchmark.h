@@ -0,0 +1,99 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+
+struct BenchmarkSettings
+{
+	int warmup = 3;
+	int min_repetitions = 10;
+	int max_repetitions = 1'000'000;
+	std::chrono::milliseconds target_time{200};
+};
+
+
+struct Statistics
+{
+	using Duration = std::chrono::duration<double, std::micro>;
+
+	Duration min{};
+	Duration median{};
+	Duration p90{};
+	Duration p99{};
+	Duration mean{};
+	Duration stddev{};
+	int repetitions = 0;
+	// cancelled after its time budget, the durations are the budget
+	bool timed_out = false;
+
+	static Statistics timeout(Duration budget)
+	{
+		auto stats = Statistics{budget, budget, budget, budget, budget};
+		stats.timed_out = true;
+		return stats;
+	}
+
+	static Statistics from(std::vector<std::chrono::nanoseconds> samples)
+	{
+		auto stats = Statistics{};
+		if (samples.empty())
+			return stats;
+		std::ranges::sort(samples);
+		// nearest-rank percentile
+		auto percentile = [&](double p)
+		{
+			const auto rank = static_cast<std::size_t>(std::ceil(p * samples.size()));
+			return Duration{samples[std::clamp<std::size_t>(rank, 1, samples.size()) - 1]};
+		};
+		stats.repetitions = samples.size();
+		stats.min = samples.front();
+		stats.median = percentile(0.5);
+		stats.p90 = percentile(0.9);
+		stats.p99 = percentile(0.99);
+		auto sum = 0.0;
+		for (const auto& sample: samples)
+			sum += Duration{sample}.count();
+		stats.mean = Duration{sum / samples.size()};
+		auto sum_squares = 0.0;
+		for (const auto& sample: samples)
+			sum_squares += std::pow(Duration{sample}.count() - stats.mean.count(), 2);
+		stats.stddev = Duration{std::sqrt(sum_squares / samples.size())};
+		return stats;
+	}
+
+	friend std::ostream& operator<<(std::ostream& os, const Statistics& stats)
+	{
+		const auto flags = os.flags();
+		const auto precision = os.precision();
+		os << std::fixed << std::setprecision(1)
+		   << "min " << std::setw(8) << stats.min.count()
+		   << ", median " << std::setw(8) << stats.median.count()
+		   << ", p90 " << std::setw(8) << stats.p90.count()
+		   << ", p99 " << std::setw(8) << stats.p99.count()
+		   << ", stddev " << std::setw(7) << stats.stddev.count()
+		   << " us (" << stats.repetitions << " runs)";
+		os.flags(flags);
+		os.precision(precision);
+		return os;
+	}
+};
+
+
+// timed_run() performs one repetition and returns the time it measured itself,
+// so set-up like opening the input can be kept out of the measurement
+Statistics benchmark(const BenchmarkSettings& settings, auto&& timed_run)
+{
+	for (auto i = 0; i < settings.warmup; ++i)
+		timed_run();
+	auto samples = std::vector<std::chrono::nanoseconds>{};
+	const auto start = std::chrono::steady_clock::now();
+	while (std::ssize(samples) < settings.max_repetitions &&
+	       (std::ssize(samples) < settings.min_repetitions ||
+	        std::chrono::steady_clock::now() - start < settings.target_time))
+		samples.push_back(timed_run());
+	return Statistics::from(std::move(samples));
+}
@@ -0,0 +1,706 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+// Generates valid puzzle inputs of a configurable size, to see how the
+// solvers scale. What size means depends on the puzzle.
+//
+//   AoC2021_gen <puzzle> <size> [--seed S]            writes to stdout
+//   AoC2021_gen <puzzle> --sweep <dir> <size>... [--seed S]
+//                                                     writes <dir>/<puzzle>.<size>.inp
+//
+// The test runner picks the sweep files up with --sweep <dir>.
+
+
+namespace
+{
+
+
+	struct Random
+	{
+		explicit Random(std::uint64_t seed) : engine(seed) {}
+
+		int operator()(int min, int max) { return std::uniform_int_distribution<int>{min, max}(engine); }
+		bool chance(double p) { return std::bernoulli_distribution{p}(engine); }
+		template<typename T>
+		const T& pick(const std::vector<T>& values) { return values[(*this)(0, std::ssize(values)-1)]; }
+		void shuffle(auto& range) { std::ranges::shuffle(range, engine); }
+
+		std::mt19937_64 engine;
+	};
+
+
+	// size: number of depth readings
+	void generate_q01(std::ostream& os, int size, Random& random)
+	{
+		auto depth = random(100, 200);
+		for (auto i = 0; i < size; ++i)
+		{
+			depth = std::max(0, depth + random(-10, 20));
+			os << depth << '\n';
+		}
+	}
+
+
+	// size: number of instructions
+	// The submarine never goes up out of the water, so the depth of part a,
+	// which is the aim of part b, stays at 0 or more. That keeps the depth of
+	// part b from going negative too.
+	void generate_q02(std::ostream& os, int size, Random& random)
+	{
+		static const auto directions = std::vector<std::string_view>{"forward", "down", "up"};
+		auto depth = 0;
+		for (auto i = 0; i < size; ++i)
+		{
+			auto direction = random.pick(directions);
+			const auto x = random(1, 9);
+			if (direction == "up" && depth < x)
+				direction = "down";
+			depth += direction == "down" ? x : direction == "up" ? -x : 0;
+			os << direction << ' ' << x << '\n';
+		}
+	}
+
+
+	void print_binary(std::ostream& os, const std::vector<int>& numbers, int width)
+	{
+		for (const auto number: numbers)
+		{
+			for (auto bit = width - 1; bit >= 0; --bit)
+				os << ((number >> bit) & 1);
+			os << '\n';
+		}
+	}
+
+
+	// size: number of lines in the report
+	// The numbers are distinct and get wider than the usual 12 bits when
+	// needed for that. The CO2 rating only finds a single number if its
+	// candidates never all agree on the next bit, so that is repaired by
+	// flipping the bit of one of them.
+	void generate_q03(std::ostream& os, int size, Random& random)
+	{
+		const auto width = std::clamp<int>(std::bit_width(2u*size), 12, 30);
+		auto unique = std::set<int>{};
+		while (std::ssize(unique) < size)
+			unique.insert(random(0, (1 << width) - 1));
+		auto numbers = std::vector<int>(unique.begin(), unique.end());
+		random.shuffle(numbers);
+		auto candidates = std::vector<int*>{};
+		for (auto& number: numbers)
+			candidates.push_back(&number);
+		for (auto bit = width - 1; bit >= 0 && candidates.size() > 1; --bit)
+		{
+			auto is_one = [&](const int* number) { return ((*number >> bit) & 1) == 1; };
+			const auto ones = std::ranges::count_if(candidates, is_one);
+			if (ones == 0 || ones == std::ssize(candidates))
+			{
+				// the flipped number cannot be a duplicate, it would be a candidate
+				*candidates.front() ^= 1 << bit;
+				return print_binary(os, numbers, width);
+			}
+			const bool least_common = 2*ones < std::ssize(candidates);
+			std::erase_if(candidates, [&](const int* number) { return is_one(number) != least_common; });
+		}
+		print_binary(os, numbers, width);
+	}
+
+
+	// size: number of bingo boards
+	void generate_q04(std::ostream& os, int size, Random& random)
+	{
+		auto numbers = std::vector<int>(100);
+		std::iota(numbers.begin(), numbers.end(), 0);
+		random.shuffle(numbers);
+		for (auto i = 0; i < std::ssize(numbers); ++i)
+			os << (i ? "," : "") << numbers[i];
+		os << '\n';
+		for (auto board = 0; board < size; ++board)
+		{
+			random.shuffle(numbers);
+			os << '\n';
+			for (auto row = 0; row < 5; ++row)
+			{
+				for (auto col = 0; col < 5; ++col)
+					os << (col ? " " : "") << std::setw(2) << numbers[5*row + col];
+				os << '\n';
+			}
+		}
+	}
+
+
+	// size: number of lines of vents
+	void generate_q05(std::ostream& os, int size, Random& random)
+	{
+		for (auto i = 0; i < size; ++i)
+		{
+			const auto x1 = random(0, 999);
+			const auto y1 = random(0, 999);
+			auto x2 = x1;
+			auto y2 = y1;
+			switch (random(0, 2))
+			{
+			case 0: x2 = random(0, 999); break;
+			case 1: y2 = random(0, 999); break;
+			case 2:
+			{
+				const auto length = random(0, 999);
+				const auto dx = random.chance(0.5) ? 1 : -1;
+				const auto dy = random.chance(0.5) ? 1 : -1;
+				const auto steps = std::min({length, dx > 0 ? 999-x1 : x1, dy > 0 ? 999-y1 : y1});
+				x2 = x1 + dx*steps;
+				y2 = y1 + dy*steps;
+			}
+			}
+			os << x1 << ',' << y1 << " -> " << x2 << ',' << y2 << '\n';
+		}
+	}
+
+
+	// size: number of fish
+	void generate_q06(std::ostream& os, int size, Random& random)
+	{
+		for (auto i = 0; i < size; ++i)
+			os << (i ? "," : "") << random(1, 5);
+		os << '\n';
+	}
+
+
+	// size: number of crabs
+	void generate_q07(std::ostream& os, int size, Random& random)
+	{
+		for (auto i = 0; i < size; ++i)
+			os << (i ? "," : "") << random(0, 1999);
+		os << '\n';
+	}
+
+
+	// size: number of displays
+	void generate_q08(std::ostream& os, int size, Random& random)
+	{
+		static const auto digits = std::vector<std::string>{
+			"abcefg", "cf", "acdeg", "acdfg", "bcdf", "abdfg", "abdefg", "acf", "abcdefg", "abcdfg"};
+		auto scrambled = [&](const std::string& wiring, const std::string& digit)
+		{
+			auto result = std::string{};
+			for (const char c: digit)
+				result += wiring[c - 'a'];
+			random.shuffle(result);
+			return result;
+		};
+		for (auto i = 0; i < size; ++i)
+		{
+			auto wiring = std::string{"abcdefg"};
+			random.shuffle(wiring);
+			auto order = std::vector<int>(10);
+			std::iota(order.begin(), order.end(), 0);
+			random.shuffle(order);
+			for (const auto digit: order)
+				os << scrambled(wiring, digits[digit]) << ' ';
+			os << '|';
+			for (auto d = 0; d < 4; ++d)
+				os << ' ' << scrambled(wiring, digits[random(0, 9)]);
+			os << '\n';
+		}
+	}
+
+
+	// size: width and height of the height map
+	// Random 9s would leave a single huge basin, so the map is split into
+	// regions around random low points with walls of 9 in between.
+	void generate_q09(std::ostream& os, int size, Random& random)
+	{
+		auto region = std::vector<int>(size*size, -1);
+		auto distance = std::vector<int>(size*size, 0);
+		auto queue = std::deque<int>{};
+		const auto num_regions = std::max(3, size*size / 60);
+		for (auto i = 0; i < num_regions; ++i)
+		{
+			const auto pos = random(0, size*size - 1);
+			if (region[pos] < 0)
+			{
+				region[pos] = i;
+				queue.push_back(pos);
+			}
+		}
+		while (!queue.empty())
+		{
+			const auto pos = queue.front();
+			queue.pop_front();
+			const auto x = pos % size;
+			for (const auto next: {x > 0 ? pos-1 : -1, x+1 < size ? pos+1 : -1, pos-size, pos+size})
+				if (next >= 0 && next < size*size && region[next] < 0)
+				{
+					region[next] = region[pos];
+					distance[next] = distance[pos] + 1;
+					queue.push_back(next);
+				}
+		}
+		for (auto y = 0; y < size; ++y)
+		{
+			for (auto x = 0; x < size; ++x)
+			{
+				const auto pos = y*size + x;
+				const bool wall =
+					(x+1 < size && region[pos+1] != region[pos]) ||
+					(y+1 < size && region[pos+size] != region[pos]);
+				os << (wall ? 9 : std::min(8, distance[pos] + random(0, 1)));
+			}
+			os << '\n';
+		}
+	}
+
+
+	// size: number of lines of chunks
+	// At most 26 chunks are open at once, so the completion score of part b,
+	// which is multiplied by 5 for every one of them, fits in 64 bits.
+	void generate_q10(std::ostream& os, int size, Random& random)
+	{
+		static constexpr auto open = std::string_view{"([{<"};
+		static constexpr auto close = std::string_view{")]}>"};
+		static constexpr auto max_open = 26;
+		for (auto i = 0; i < size; ++i)
+		{
+			auto stack = std::string{};
+			const auto length = random(20, 110);
+			const bool corrupt = random.chance(0.5);
+			auto line = std::string{};
+			for (auto c = 0; c < length; ++c)
+			{
+				if (stack.empty() || (std::ssize(stack) < max_open && random.chance(0.55)))
+				{
+					const auto type = random(0, 3);
+					stack.push_back(close[type]);
+					line += open[type];
+				}
+				else
+				{
+					line += stack.back();
+					stack.pop_back();
+				}
+			}
+			if (corrupt)
+			{
+				// close with the wrong bracket
+				const auto expected = stack.empty() ? ')' : stack.back();
+				line += close[(close.find(expected) + random(1, 3)) % 4];
+			}
+			else if (stack.empty())
+				line += '(';
+			os << line << '\n';
+		}
+	}
+
+
+	// Not every grid ever flashes all at once, so grids are drawn until one
+	// does within a reasonable number of steps.
+	bool octopuses_synchronise(std::array<int, 100> energy)
+	{
+		for (auto step = 0; step < 2000; ++step)
+		{
+			auto flashing = std::vector<int>{};
+			for (auto i = 0; i < 100; ++i)
+				if (++energy[i] == 10)
+					flashing.push_back(i);
+			for (auto f = 0u; f < flashing.size(); ++f)
+			{
+				const auto x = flashing[f] % 10;
+				const auto y = flashing[f] / 10;
+				for (auto ny = std::max(0, y-1); ny <= std::min(9, y+1); ++ny)
+					for (auto nx = std::max(0, x-1); nx <= std::min(9, x+1); ++nx)
+						if (++energy[ny*10 + nx] == 10)
+							flashing.push_back(ny*10 + nx);
+			}
+			if (flashing.size() == 100)
+				return true;
+			for (const auto i: flashing)
+				energy[i] = 0;
+		}
+		return false;
+	}
+
+	// the solver has a fixed 10x10 grid, size is ignored
+	void generate_q11(std::ostream& os, int, Random& random)
+	{
+		auto energy = std::array<int, 100>{};
+		do
+			std::ranges::generate(energy, [&] { return random(0, 9); });
+		while (!octopuses_synchronise(energy));
+		for (auto y = 0; y < 10; ++y)
+		{
+			for (auto x = 0; x < 10; ++x)
+				os << energy[y*10 + x];
+			os << '\n';
+		}
+	}
+
+
+	// size: number of branches from start to end, from 1 to 25
+	// Every branch enters a small cave from start, goes on to a big cave that
+	// leads to end and has one or two dead end small caves, and sometimes
+	// goes to end directly as well. Branches only meet at start and end, so
+	// the number of paths grows linearly with size, and the solver finds
+	// them one by one. The solver supports up to 127 caves.
+	void generate_q12(std::ostream& os, int size, Random& random)
+	{
+		if (size < 1 || size > 25)
+			throw std::runtime_error("The size of q12 must be from 1 to 25");
+		auto num_small = 0;
+		auto num_big = 0;
+		// letters only, like the puzzle, and never "end" or "start"
+		auto name = [](int index, char first)
+		{
+			auto letters = std::string{};
+			do
+			{
+				letters += static_cast<char>(first + index%26);
+				index /= 26;
+			} while (index > 0);
+			return letters;
+		};
+		auto tunnels = std::vector<std::string>{};
+		for (auto i = 0; i < size; ++i)
+		{
+			const auto entry = name(num_small++, 'a');
+			const auto big = name(num_big++, 'A');
+			tunnels.push_back("start-" + entry);
+			tunnels.push_back(entry + '-' + big);
+			tunnels.push_back(big + "-end");
+			for (auto j = random(1, 2); j > 0; --j)
+				tunnels.push_back(big + '-' + name(num_small++, 'a'));
+			if (random.chance(0.5))
+				tunnels.push_back(entry + "-end");
+		}
+		random.shuffle(tunnels);
+		for (const auto& tunnel: tunnels)
+			os << tunnel << '\n';
+	}
+
+
+	// size: number of dots
+	void generate_q13(std::ostream& os, int size, Random& random)
+	{
+		// every fold halves the paper, the code left after folding is 40x6
+		auto folds = std::vector<std::pair<char, int>>{};
+		auto width = 40;
+		auto height = 6;
+		for (auto i = 0; i < 12; ++i)
+			if (i % 2 == 0)
+			{
+				folds.emplace_back('x', width);
+				width = 2*width + 1;
+			}
+			else
+			{
+				folds.emplace_back('y', height);
+				height = 2*height + 1;
+			}
+		auto dots = std::set<std::pair<int, int>>{};
+		while (std::ssize(dots) < std::min<std::int64_t>(size, std::int64_t{width}*height/2))
+		{
+			const auto x = random(0, width-1);
+			const auto y = random(0, height-1);
+			const auto on_fold = std::ranges::any_of(folds, [&](const auto& fold)
+			{
+				return (fold.first == 'x') ? x == fold.second : y == fold.second;
+			});
+			if (!on_fold)
+				dots.emplace(x, y);
+		}
+		for (const auto& [x, y]: dots)
+			os << x << ',' << y << '\n';
+		os << '\n';
+		std::ranges::reverse(folds);
+		for (const auto& [axis, location]: folds)
+			os << "fold along " << axis << '=' << location << '\n';
+	}
+
+
+	// size: length of the polymer template
+	void generate_q14(std::ostream& os, int size, Random& random)
+	{
+		const auto elements = std::string{"BCFHKNOPSV"};
+		for (auto i = 0; i < size; ++i)
+			os << elements[random(0, elements.size()-1)];
+		os << "\n\n";
+		for (const char a: elements)
+			for (const char b: elements)
+				os << a << b << " -> " << elements[random(0, elements.size()-1)] << '\n';
+	}
+
+
+	// size: width and height of the cave
+	void generate_q15(std::ostream& os, int size, Random& random)
+	{
+		for (auto y = 0; y < size; ++y)
+		{
+			for (auto x = 0; x < size; ++x)
+				os << random(1, 9);
+			os << '\n';
+		}
+	}
+
+
+	// size: number of literal packets
+	void generate_q16(std::ostream& os, int size, Random& random)
+	{
+		auto bits = std::vector<bool>{};
+		auto push = [&](std::uint64_t value, int num_bits)
+		{
+			for (auto i = num_bits-1; i >= 0; --i)
+				bits.push_back((value >> i) & 1);
+		};
+		auto literal = [&](int max)
+		{
+			push(random(0, 7), 3);
+			push(4, 3);
+			const auto value = random(0, max);
+			for (auto group = (value > 15) + (value > 255); group >= 0; --group)
+				push(((group > 0) << 4) | ((value >> (4*group)) & 0xF), 5);
+		};
+		// budget: number of literals in the packet and its sub packets
+		auto packet = [&](int budget, auto&& next) -> void
+		{
+			if (budget <= 1)
+			{
+				literal(4095);
+				return;
+			}
+			push(random(0, 7), 3);
+			// only products of two small literals, to keep the result in range
+			const auto type = std::vector{0, 0, 1, 2, 3, 5, 6, 7}[random(0, 7)];
+			push(type, 3);
+			if (type == 1)
+			{
+				push(1, 1);
+				push(2, 11);
+				literal(15);
+				literal(15);
+				return;
+			}
+			const auto num_sub_packets = (type >= 5) ? 2 : std::min(budget, random(2, 5));
+			auto sub_packets = [&]
+			{
+				for (auto i = 0; i < num_sub_packets; ++i)
+					next(budget/num_sub_packets + (i < budget%num_sub_packets), next);
+			};
+			// the length in bits only fits 15 bits for small packets
+			if (budget > 500 || random.chance(0.5))
+			{
+				push(1, 1);
+				push(num_sub_packets, 11);
+				sub_packets();
+			}
+			else
+			{
+				push(0, 1);
+				const auto length_position = bits.size();
+				push(0, 15);
+				sub_packets();
+				const auto length = bits.size() - length_position - 15;
+				for (auto i = 0; i < 15; ++i)
+					bits[length_position + i] = (length >> (14-i)) & 1;
+			}
+		};
+		packet(std::max(size, 1), packet);
+		while (bits.size() % 4 != 0)
+			bits.push_back(false);
+		for (auto i = 0u; i < bits.size(); i += 4)
+			os << "0123456789ABCDEF"[bits[i]*8 + bits[i+1]*4 + bits[i+2]*2 + bits[i+3]];
+		os << '\n';
+	}
+
+
+	// size: distance of the target area
+	void generate_q17(std::ostream& os, int size, Random& random)
+	{
+		const auto x = std::max(size, 10);
+		const auto y = std::max(size, 10);
+		os << "target area: x=" << x << ".." << x + random(x/10, x/2)
+		   << ", y=" << -y - random(y/10, y/2) << ".." << -y << '\n';
+	}
+
+
+	// size: number of snailfish numbers
+	void generate_q18(std::ostream& os, int size, Random& random)
+	{
+		// already reduced: nested at most 4 deep, regular numbers below 10
+		auto number = [&](int depth, auto&& next) -> void
+		{
+			if (depth > 0 && (depth == 4 || random.chance(0.3)))
+				os << random(0, 9);
+			else
+			{
+				os << '[';
+				next(depth+1, next);
+				os << ',';
+				next(depth+1, next);
+				os << ']';
+			}
+		};
+		for (auto i = 0; i < size; ++i)
+		{
+			number(0, number);
+			os << '\n';
+		}
+	}
+
+
+	// size: number of scanners
+	void generate_q19(std::ostream& os, int size, Random& random)
+	{
+		using Pos = std::array<int, 3>;
+		// all 24 rotations: signed permutations of the axes with determinant 1
+		auto rotations = std::vector<std::array<Pos, 3>>{};
+		auto permutation = std::array{0, 1, 2};
+		do
+			for (auto signs = 0; signs < 8; ++signs)
+			{
+				auto m = std::array<Pos, 3>{};
+				for (auto row = 0; row < 3; ++row)
+					m[row][permutation[row]] = (signs >> row & 1) ? -1 : 1;
+				const auto det =
+					m[0][0]*(m[1][1]*m[2][2] - m[1][2]*m[2][1]) -
+					m[0][1]*(m[1][0]*m[2][2] - m[1][2]*m[2][0]) +
+					m[0][2]*(m[1][0]*m[2][1] - m[1][1]*m[2][0]);
+				if (det == 1)
+					rotations.push_back(m);
+			}
+		while (std::ranges::next_permutation(permutation).found);
+		auto in_range = [](const Pos& scanner, const Pos& beacon)
+		{
+			for (auto axis = 0; axis < 3; ++axis)
+				if (std::abs(beacon[axis] - scanner[axis]) > 1000)
+					return false;
+			return true;
+		};
+		auto random_pos = [&](const Pos& min, const Pos& max)
+		{
+			return Pos{random(min[0], max[0]), random(min[1], max[1]), random(min[2], max[2])};
+		};
+		// every scanner overlaps with an earlier one with at least 12 beacons in common
+		auto scanners = std::vector<Pos>{{0, 0, 0}};
+		auto beacons = std::set<Pos>{};
+		for (auto i = 0; i < 26; ++i)
+			beacons.insert(random_pos({-1000, -1000, -1000}, {1000, 1000, 1000}));
+		for (auto s = 1; s < std::max(size, 1); ++s)
+		{
+			const auto& previous = scanners[random(0, s-1)];
+			auto scanner = previous;
+			for (auto& coordinate: scanner)
+				coordinate += random(-1100, 1100);
+			auto overlap_min = Pos{};
+			auto overlap_max = Pos{};
+			for (auto axis = 0; axis < 3; ++axis)
+			{
+				overlap_min[axis] = std::max(scanner[axis], previous[axis]) - 1000;
+				overlap_max[axis] = std::min(scanner[axis], previous[axis]) + 1000;
+			}
+			auto shared = std::ranges::count_if(beacons, [&](const Pos& b) { return in_range(scanner, b) && in_range(previous, b); });
+			for (; shared < 12; ++shared)
+				beacons.insert(random_pos(overlap_min, overlap_max));
+			for (auto i = 0; i < 14; ++i)
+				beacons.insert(random_pos({scanner[0]-1000, scanner[1]-1000, scanner[2]-1000}, {scanner[0]+1000, scanner[1]+1000, scanner[2]+1000}));
+			scanners.push_back(scanner);
+		}
+		for (auto s = 0; s < std::ssize(scanners); ++s)
+		{
+			const auto& rotation = rotations[s == 0 ? 0 : random(0, 23)];
+			os << "--- scanner " << s << " ---\n";
+			for (const auto& beacon: beacons)
+				if (in_range(scanners[s], beacon))
+				{
+					auto relative = Pos{};
+					for (auto row = 0; row < 3; ++row)
+						for (auto col = 0; col < 3; ++col)
+							relative[row] += rotation[row][col] * (beacon[col] - scanners[s][col]);
+					os << relative[0] << ',' << relative[1] << ',' << relative[2] << '\n';
+				}
+			if (s+1 < std::ssize(scanners))
+				os << '\n';
+		}
+	}
+
+
+	const auto generators = std::map<std::string_view, std::function<void(std::ostream&, int, Random&)>>{
+		{"q01", generate_q01},
+		{"q02", generate_q02},
+		{"q03", generate_q03},
+		{"q04", generate_q04},
+		{"q05", generate_q05},
+		{"q06", generate_q06},
+		{"q07", generate_q07},
+		{"q08", generate_q08},
+		{"q09", generate_q09},
+		{"q10", generate_q10},
+		{"q11", generate_q11},
+		{"q12", generate_q12},
+		{"q13", generate_q13},
+		{"q14", generate_q14},
+		{"q15", generate_q15},
+		{"q16", generate_q16},
+		{"q17", generate_q17},
+		{"q18", generate_q18},
+		{"q19", generate_q19},
+	};
+
+
+}
+
+
+int main(int argc, char** argv)
+{
+	auto args = std::vector<std::string_view>(argv + 1, argv + argc);
+	auto seed = std::uint64_t{2021};
+	if (const auto it = std::ranges::find(args, "--seed"); it != args.end())
+	{
+		if (it + 1 == args.end())
+			throw std::runtime_error("Missing value for --seed");
+		seed = std::stoull(std::string{*(it + 1)});
+		args.erase(it, it + 2);
+	}
+	if (args.size() < 2 || !generators.contains(args[0]))
+	{
+		std::cerr << "Usage: " << argv[0] << " <puzzle> <size> [--seed S]\n"
+		          << "       " << argv[0] << " <puzzle> --sweep <dir> <size>... [--seed S]\n"
+		          << "with puzzle one of q01..q19" << std::endl;
+		return 1;
+	}
+	const auto& generate = generators.at(args[0]);
+	if (args[1] == "--sweep")
+	{
+		if (args.size() < 4)
+			throw std::runtime_error("Missing directory or sizes for --sweep");
+		const auto dir = std::filesystem::path{args[2]};
+		std::filesystem::create_directories(dir);
+		for (const auto size: args | std::views::drop(3))
+		{
+			// every size gets the same seed, so a sweep can be extended later
+			auto random = Random{seed};
+			auto os = std::ofstream(dir / (std::string{args[0]} + '.' + std::string{size} + ".inp"));
+			generate(os, std::stoi(std::string{size}), random);
+		}
+	}
+	else
+	{
+		auto random = Random{seed};
+		generate(std::cout, std::stoi(std::string{args[1]}), random);
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#ifdef __unix__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+// Read-only view of a whole file. Maps the file into memory where possible,
+// otherwise falls back to reading it into a string.
+class MappedFile
+{
+public:
+	explicit MappedFile(const std::filesystem::path& path)
+	{
+#ifdef __unix__
+		const auto fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			throw std::runtime_error("Could not find " + path.string() + ": " + std::strerror(errno));
+		struct stat file_stat;
+		if (fstat(fd, &file_stat) != 0)
+		{
+			const auto error = errno;
+			close(fd);
+			throw std::runtime_error("Could not stat " + path.string() + ": " + std::strerror(error));
+		}
+		if (file_stat.st_size > 0)
+		{
+			auto flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+			// read the whole file now, so page faults are not part of parsing
+			flags |= MAP_POPULATE;
+#endif
+			if (auto* const address = mmap(nullptr, file_stat.st_size, PROT_READ, flags, fd, 0); address != MAP_FAILED)
+			{
+				mapping = address;
+				contents = std::string_view{static_cast<const char*>(address), static_cast<std::size_t>(file_stat.st_size)};
+			}
+		}
+		close(fd);
+		if (mapping != nullptr || file_stat.st_size == 0)
+			return;
+#endif
+		std::ifstream is(path, std::ios::binary);
+		if (!is.good())
+			throw std::runtime_error("Could not find " + path.string());
+		storage.assign(std::istreambuf_iterator<char>{is}, std::istreambuf_iterator<char>{});
+		contents = storage;
+	}
+
+	MappedFile(MappedFile&& other) noexcept :
+		mapping(std::exchange(other.mapping, nullptr)),
+		storage(std::move(other.storage)),
+		contents(mapping ? std::exchange(other.contents, {}) : std::string_view{storage})
+	{
+	}
+
+	MappedFile& operator=(MappedFile&&) = delete;
+
+	~MappedFile()
+	{
+#ifdef __unix__
+		if (mapping != nullptr)
+			munmap(mapping, contents.size());
+#endif
+	}
+
+	std::string_view view() const { return contents; }
+
+private:
+	void* mapping = nullptr;
+	std::string storage;
+	std::string_view contents;
+};
@@ -0,0 +1,209 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <ostream>
+#include <string>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+// Hardware performance counters of the calling thread, read through
+// perf_event_open. Counters that cannot be opened (no permission due to
+// perf_event_paranoid, not supported by the CPU or a VM, not Linux) are
+// reported as missing instead of failing.
+class PerfCounters
+{
+public:
+	enum Counter
+	{
+		CYCLES,
+		INSTRUCTIONS,
+		BRANCHES,
+		BRANCH_MISSES,
+		L1D_MISSES,
+		LLC_MISSES,
+		NUM_COUNTERS,
+	};
+
+	struct Sample
+	{
+		std::array<std::optional<std::uint64_t>, NUM_COUNTERS> counts;
+
+		friend std::ostream& operator<<(std::ostream& os, const Sample& sample)
+		{
+			const auto& c = sample.counts;
+			auto ratio = [&](Counter numerator, Counter denominator, double factor, const char* prefix, const char* suffix)
+			{
+				if (c[numerator] && c[denominator] && *c[denominator] > 0)
+					os << prefix << std::round(factor * *c[numerator] / *c[denominator] * 100) / 100 << suffix;
+			};
+			ratio(INSTRUCTIONS, CYCLES, 1, ", IPC ", "");
+			ratio(BRANCH_MISSES, BRANCHES, 100, ", branch misses ", "%");
+			ratio(L1D_MISSES, INSTRUCTIONS, 1000, ", L1D ", " MPKI");
+			ratio(LLC_MISSES, INSTRUCTIONS, 1000, ", LLC ", " MPKI");
+			return os;
+		}
+	};
+
+	// counters are per thread, so every thread opens its own set once
+	static PerfCounters& for_this_thread()
+	{
+		thread_local auto counters = PerfCounters{};
+		return counters;
+	}
+
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	~PerfCounters()
+	{
+#ifdef __linux__
+		for (const auto fd: fds)
+			if (fd >= 0)
+				close(fd);
+#endif
+	}
+
+	bool available() const { return leader >= 0; }
+	const std::string& error() const { return open_error; }
+
+	// The counters keep counting from where they were, the sample is the
+	// difference with the reading at the start, including the times the
+	// group was enabled and running.
+	void start()
+	{
+#ifdef __linux__
+		if (leader < 0)
+			return;
+		ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+		start_reading = read_group();
+#endif
+	}
+
+	Sample stop()
+	{
+		auto sample = Sample{};
+#ifdef __linux__
+		if (leader < 0)
+			return sample;
+		const auto reading = read_group();
+		ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+		if (!reading || !start_reading)
+			return sample;
+		const auto enabled = (*reading)[1] - (*start_reading)[1];
+		const auto running = (*reading)[2] - (*start_reading)[2];
+		if (running == 0)
+			return sample;
+		// the group is scheduled as a whole, scaled up when it had to share
+		// the hardware with others
+		auto position = 3;
+		for (auto i = 0; i < NUM_COUNTERS; ++i)
+			if (fds[i] >= 0)
+			{
+				const auto count = (*reading)[position] - (*start_reading)[position];
+				sample.counts[i] = static_cast<std::uint64_t>(static_cast<double>(count) * enabled / running);
+				++position;
+			}
+#endif
+		return sample;
+	}
+
+private:
+	// number of counters, time enabled, time running, then the value of
+	// every counter in the order they were opened
+	using Reading = std::array<std::uint64_t, 3 + NUM_COUNTERS>;
+
+	explicit PerfCounters()
+	{
+		fds.fill(-1);
+#ifdef __linux__
+		// the first counter that opens leads the group, so all of them count
+		// over the same time
+		auto open = [&](Counter counter, std::uint32_t type, std::uint64_t config)
+		{
+			auto attr = perf_event_attr{};
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = type;
+			attr.config = config;
+			attr.disabled = leader < 0;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+			fds[counter] = syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+			if (fds[counter] < 0 && open_error.empty())
+				open_error = std::strerror(errno);
+			if (leader < 0)
+				leader = fds[counter];
+		};
+		open(CYCLES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+		open(INSTRUCTIONS, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+		open(BRANCHES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS);
+		open(BRANCH_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+		open(L1D_MISSES, PERF_TYPE_HW_CACHE,
+			PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+		open(LLC_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+#else
+		open_error = "only supported on Linux";
+#endif
+	}
+
+#ifdef __linux__
+	std::optional<Reading> read_group() const
+	{
+		auto reading = Reading{};
+		const auto size = static_cast<ssize_t>((3 + std::ranges::count_if(fds, [](int fd) { return fd >= 0; })) * sizeof(std::uint64_t));
+		if (read(leader, reading.data(), sizeof(reading)) != size)
+			return std::nullopt;
+		return reading;
+	}
+#endif
+
+	std::array<int, NUM_COUNTERS> fds;
+	int leader = -1;
+	std::optional<Reading> start_reading;
+	std::string open_error;
+};
+
+
+// Counts from construction to stop(), or to the end of the scope when the
+// run throws, like when it is cancelled, so the counters never keep
+// counting. Does nothing without counters.
+class PerfScope
+{
+public:
+	explicit PerfScope(PerfCounters* counters) :
+		counters(counters)
+	{
+		if (counters)
+			counters->start();
+	}
+
+	PerfScope(const PerfScope&) = delete;
+	PerfScope& operator=(const PerfScope&) = delete;
+
+	~PerfScope()
+	{
+		if (counters)
+			counters->stop();
+	}
+
+	PerfCounters::Sample stop()
+	{
+		auto sample = counters ? counters->stop() : PerfCounters::Sample{};
+		counters = nullptr;
+		return sample;
+	}
+
+private:
+	PerfCounters* counters;
+};
@@ -0,0 +1,144 @@
+#pragma once
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "benchmark.h"
+
+
+struct TimingRecord
+{
+	std::string name;
+	std::string input;
+	Statistics statistics;
+};
+
+
+inline void write_csv(std::ostream& os, const std::vector<TimingRecord>& records)
+{
+	os << "test,input,runs,min_us,median_us,p90_us,p99_us,mean_us,stddev_us,timed_out\n";
+	os << std::fixed << std::setprecision(3);
+	for (const auto& [name, input, stats]: records)
+		os << name << ',' << input << ',' << stats.repetitions << ','
+		   << stats.min.count() << ',' << stats.median.count() << ','
+		   << stats.p90.count() << ',' << stats.p99.count() << ','
+		   << stats.mean.count() << ',' << stats.stddev.count() << ','
+		   << stats.timed_out << '\n';
+}
+
+
+inline void write_json(std::ostream& os, const std::vector<TimingRecord>& records)
+{
+	auto quoted = [](const std::string& s)
+	{
+		auto result = std::string{"\""};
+		for (const char c: s)
+		{
+			if (c == '"' || c == '\\')
+				result += '\\';
+			result += c;
+		}
+		return result + '"';
+	};
+	os << std::fixed << std::setprecision(3) << "[\n";
+	for (auto i = 0u; i < records.size(); ++i)
+	{
+		const auto& [name, input, stats] = records[i];
+		os << "  {\"test\": " << quoted(name) << ", \"input\": " << quoted(input)
+		   << ", \"runs\": " << stats.repetitions
+		   << ", \"min_us\": " << stats.min.count()
+		   << ", \"median_us\": " << stats.median.count()
+		   << ", \"p90_us\": " << stats.p90.count()
+		   << ", \"p99_us\": " << stats.p99.count()
+		   << ", \"mean_us\": " << stats.mean.count()
+		   << ", \"stddev_us\": " << stats.stddev.count()
+		   << ", \"timed_out\": " << (stats.timed_out ? "true" : "false") << '}'
+		   << (i+1 < records.size() ? ",\n" : "\n");
+	}
+	os << "]\n";
+}
+
+
+// reads the format written by write_csv, also from before it had the
+// timed_out column
+inline std::vector<TimingRecord> read_csv(const std::filesystem::path& path)
+{
+	auto is = std::ifstream(path);
+	if (!is.good())
+		throw std::runtime_error("Could not open " + path.string());
+	auto records = std::vector<TimingRecord>{};
+	auto line = std::string{};
+	std::getline(is, line);
+	while (std::getline(is, line))
+	{
+		auto fields = std::vector<std::string>{};
+		auto field_stream = std::istringstream{line};
+		for (auto field = std::string{}; std::getline(field_stream, field, ',');)
+			fields.push_back(field);
+		if (fields.size() != 9 && fields.size() != 10)
+			throw std::runtime_error("Unexpected line in " + path.string() + ": " + line);
+		auto us = [&](int i) { return Statistics::Duration{std::stod(fields[i])}; };
+		auto& record = records.emplace_back(TimingRecord{fields[0], fields[1], {}});
+		record.statistics.repetitions = std::stoi(fields[2]);
+		record.statistics.min = us(3);
+		record.statistics.median = us(4);
+		record.statistics.p90 = us(5);
+		record.statistics.p99 = us(6);
+		record.statistics.mean = us(7);
+		record.statistics.stddev = us(8);
+		record.statistics.timed_out = (fields.size() == 10 && fields[9] == "1");
+	}
+	return records;
+}
+
+
+struct RegressionThreshold
+{
+	double relative = 0.10;
+	Statistics::Duration absolute{50};
+};
+
+// Compares the medians, a test regressed if it got slower by more than both
+// the relative and the absolute threshold, or if it timed out when it did not
+// in the baseline. Returns the number of regressions.
+inline int report_regressions(
+	std::ostream& os,
+	const std::vector<TimingRecord>& baseline,
+	const std::vector<TimingRecord>& records,
+	const RegressionThreshold& threshold)
+{
+	auto baseline_statistics = std::map<std::pair<std::string, std::string>, Statistics>{};
+	for (const auto& record: baseline)
+		baseline_statistics.emplace(std::make_pair(record.name, record.input), record.statistics);
+	auto regressions = 0;
+	for (const auto& [name, input, stats]: records)
+	{
+		const auto it = baseline_statistics.find(std::make_pair(name, input));
+		if (it == baseline_statistics.end())
+			continue;
+		const auto before = it->second.median;
+		const auto after = stats.median;
+		if (stats.timed_out && !it->second.timed_out)
+		{
+			++regressions;
+			os << "Test " << name << " regressed with input " << input << ": median "
+			   << std::lround(before.count()) << " us -> timeout after " << std::lround(after.count()) << " us" << std::endl;
+		}
+		else if (after > before * (1 + threshold.relative) && after - before > threshold.absolute)
+		{
+			++regressions;
+			os << "Test " << name << " regressed with input " << input << ": median "
+			   << std::lround(before.count()) << " us -> " << std::lround(after.count()) << " us";
+			if (before.count() > 0)
+				os << " (+" << std::lround(100 * (after / before - 1)) << "%)";
+			os << std::endl;
+		}
+	}
+	return regressions;
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include "benchmark.h"
+#include "mapped_file.h"
+
+
+// 64 bit FNV-1a
+inline std::uint64_t content_hash(std::string_view data)
+{
+	auto hash = std::uint64_t{0xcbf29ce484222325};
+	for (const unsigned char c: data)
+		hash = (hash ^ c) * 0x100000001b3;
+	return hash;
+}
+
+
+// On-disk cache of answers and timings of earlier runs. An entry is only
+// valid for the same test, the same input contents and the same binary, so
+// a rebuild invalidates everything; entries of other builds are dropped
+// when the cache is saved.
+//
+// One entry per line: name, input hash, build id, runs, the timings in us
+// and the answer, with backslashes and newlines escaped.
+class ResultCache
+{
+public:
+	struct Key
+	{
+		std::string name;
+		std::uint64_t input_hash;
+
+		auto operator<=>(const Key&) const = default;
+	};
+
+	struct Entry
+	{
+		std::string answer;
+		Statistics statistics;
+	};
+
+	explicit ResultCache(std::filesystem::path cache_path, const std::filesystem::path& executable) :
+		path(std::move(cache_path)),
+		build_id(content_hash(MappedFile(executable).view()))
+	{
+		auto is = std::ifstream(path);
+		for (auto line = std::string{}; std::getline(is, line);)
+		{
+			auto fields = std::istringstream{line};
+			auto key = Key{};
+			auto entry_build_id = std::uint64_t{};
+			auto entry = Entry{};
+			auto& stats = entry.statistics;
+			auto us = [&](Statistics::Duration& duration)
+			{
+				auto count = 0.0;
+				fields >> count;
+				duration = Statistics::Duration{count};
+			};
+			fields >> key.name >> std::hex >> key.input_hash >> entry_build_id >> std::dec >> stats.repetitions;
+			us(stats.min);
+			us(stats.median);
+			us(stats.p90);
+			us(stats.p99);
+			us(stats.mean);
+			us(stats.stddev);
+			fields.get();
+			if (!fields || entry_build_id != build_id)
+				continue;
+			entry.answer = unescape(std::string{std::istreambuf_iterator<char>{fields}, {}});
+			entries.insert_or_assign(std::move(key), std::move(entry));
+		}
+	}
+
+	std::optional<Entry> find(const Key& key) const
+	{
+		auto lock = std::scoped_lock{mutex};
+		if (const auto it = entries.find(key); it != entries.end())
+			return it->second;
+		return std::nullopt;
+	}
+
+	void store(Key key, Entry entry)
+	{
+		auto lock = std::scoped_lock{mutex};
+		entries.insert_or_assign(std::move(key), std::move(entry));
+		modified = true;
+	}
+
+	void save() const
+	{
+		auto lock = std::scoped_lock{mutex};
+		if (!modified)
+			return;
+		auto os = std::ofstream(path);
+		os << std::fixed << std::setprecision(3);
+		for (const auto& [key, entry]: entries)
+		{
+			const auto& stats = entry.statistics;
+			os << key.name << std::hex << ' ' << key.input_hash << ' ' << build_id << std::dec << ' ' << stats.repetitions
+			   << ' ' << stats.min.count() << ' ' << stats.median.count() << ' ' << stats.p90.count()
+			   << ' ' << stats.p99.count() << ' ' << stats.mean.count() << ' ' << stats.stddev.count()
+			   << ' ' << escape(entry.answer) << '\n';
+		}
+	}
+
+private:
+	static std::string escape(std::string_view s)
+	{
+		auto result = std::string{};
+		for (const char c: s)
+			if (c == '\\')
+				result += "\\\\";
+			else if (c == '\n')
+				result += "\\n";
+			else
+				result += c;
+		return result;
+	}
+
+	static std::string unescape(std::string_view s)
+	{
+		auto result = std::string{};
+		for (auto i = 0u; i < s.size(); ++i)
+			if (s[i] == '\\' && i+1 < s.size())
+				result += (s[++i] == 'n') ? '\n' : s[i];
+			else
+				result += s[i];
+		return result;
+	}
+
+	std::filesystem::path path;
+	std::uint64_t build_id;
+	mutable std::mutex mutex;
+	std::map<Key, Entry> entries;
+	bool modified = false;
+};
@@ -0,0 +1,273 @@
+#pragma once
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <spanstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "result_cache.h"
+#include "thread_pool.h"
+#include "src/util.h"
+#ifdef __unix__
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+
+// Keeps the solvers resident behind a Unix domain socket, so clients do not
+// pay for starting a process per input.
+//
+// A client sends any number of requests over a connection:
+//   <test name> <number of bytes>\n<input bytes>
+// and gets a response for each, numbered from 0 in the order of the
+// requests, possibly out of order because they are solved in parallel:
+//   <request number> ok <time in us> <number of bytes>\n<answer>
+//   <request number> error <number of bytes>\n<message>
+class SolverServer
+{
+public:
+	using Solver = std::function<std::string(std::istream&)>;
+
+	// larger requests are refused, their input is not read
+	static constexpr auto max_input_size = std::size_t{256} << 20;
+	static constexpr auto max_header_size = std::size_t{1024};
+
+	explicit SolverServer(std::map<std::string, Solver, std::less<>> s, unsigned num_threads, ResultCache* result_cache) :
+		solvers(std::move(s)),
+		pool(num_threads),
+		cache(result_cache)
+	{
+	}
+
+	// returns after SIGINT, SIGTERM or stop(), throws when the socket cannot
+	// be set up
+	void serve(const std::filesystem::path& socket_path)
+	{
+#ifdef __unix__
+		const auto listener = socket(AF_UNIX, SOCK_STREAM, 0);
+		auto address = sockaddr_un{};
+		address.sun_family = AF_UNIX;
+		if (listener < 0 || socket_path.native().size() >= sizeof(address.sun_path))
+			throw std::runtime_error("Could not create socket " + socket_path.string());
+		std::strcpy(address.sun_path, socket_path.c_str());
+		// only a socket left behind by an earlier server is replaced
+		if (std::filesystem::is_socket(socket_path))
+			std::filesystem::remove(socket_path);
+		else if (std::filesystem::exists(socket_path))
+			throw std::runtime_error("Will not replace " + socket_path.string() + ", it is not a socket");
+		if (bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0)
+			throw std::runtime_error("Could not listen on " + socket_path.string() + ": " + std::strerror(errno));
+		std::cout << "Serving " << solvers.size() << " tests on " << socket_path << " with " << pool.size() << " threads" << std::endl;
+		std::signal(SIGINT, [](int) { stop_requested = 1; });
+		std::signal(SIGTERM, [](int) { stop_requested = 1; });
+		// any thread may get the signal, so the flag is checked regularly
+		// instead of relying on it interrupting accept
+		auto poll_listener = pollfd{listener, POLLIN, 0};
+		while (!stop_requested && !stopping)
+		{
+			std::erase_if(readers, [](Reader& reader)
+			{
+				if (!reader.connection->done_reading)
+					return false;
+				reader.thread.join();
+				return true;
+			});
+			if (poll(&poll_listener, 1, 200) <= 0)
+				continue;
+			if (const auto fd = accept(listener, nullptr, nullptr); fd >= 0)
+			{
+				auto connection = std::make_shared<Connection>(fd);
+				readers.push_back({connection, std::thread([this, connection]
+				{
+					// an exception must not escape the thread and end the server
+					try
+					{
+						read_requests(connection);
+					}
+					catch (const std::exception& e)
+					{
+						std::cerr << "Closing connection: " << e.what() << std::endl;
+					}
+					connection->done_reading = true;
+				})});
+			}
+		}
+		// Shutting down the connections of clients that are still connected
+		// makes their reads fail, so every reader returns. The answers that
+		// are still being solved are cached, but no longer sent.
+		for (auto& reader: readers)
+		{
+			shutdown(reader.connection->fd, SHUT_RDWR);
+			reader.thread.join();
+		}
+		readers.clear();
+		for (auto num_left = num_solving.load(); num_left > 0; num_left = num_solving.load())
+			num_solving.wait(num_left);
+		close(listener);
+		std::filesystem::remove(socket_path);
+		if (cache)
+			cache->save();
+		std::cout << "Stopped serving" << std::endl;
+#else
+		throw std::runtime_error("Serving is only supported on Unix, not on " + socket_path.string());
+#endif
+	}
+
+	// makes serve() return, from any thread
+	void stop() { stopping = true; }
+
+private:
+	// shared by the thread reading the requests and the tasks answering them,
+	// closed when all of them are done
+	struct Connection
+	{
+		explicit Connection(int f) : fd(f) {}
+		Connection(const Connection&) = delete;
+		~Connection() { close(fd); }
+
+		bool read_exactly(char* data, std::size_t size)
+		{
+			while (size > 0)
+			{
+				const auto num_read = read(fd, data, size);
+				if (num_read <= 0)
+					return false;
+				data += num_read;
+				size -= num_read;
+			}
+			return true;
+		}
+
+		void write_response(std::string_view header, std::string_view body)
+		{
+			auto lock = std::scoped_lock{write_mutex};
+			for (const auto part: {header, body})
+				for (auto written = std::size_t{0}; written < part.size();)
+				{
+					// a client that went away must not raise SIGPIPE
+					const auto num_written = send(fd, part.data() + written, part.size() - written, MSG_NOSIGNAL);
+					if (num_written <= 0)
+						return;
+					written += num_written;
+				}
+		}
+
+		int fd;
+		std::mutex write_mutex;
+		std::atomic<bool> done_reading = false;
+	};
+
+	struct Reader
+	{
+		std::shared_ptr<Connection> connection;
+		std::thread thread;
+	};
+
+	void read_requests(std::shared_ptr<Connection> connection)
+	{
+		for (auto request_number = 0;; ++request_number)
+		{
+			auto header = std::string{};
+			for (char c = 0; c != '\n';)
+			{
+				if (header.size() == max_header_size)
+					return respond_error(*connection, request_number, "Request header is longer than " + std::to_string(max_header_size) + " bytes");
+				if (!connection->read_exactly(&c, 1))
+					return;
+				header += c;
+			}
+			auto name = std::string{};
+			auto size = std::size_t{};
+			if (!(std::ispanstream{std::span<const char>{header}} >> name >> size))
+				return respond_error(*connection, request_number, "Invalid request " + header);
+			// the rest of the connection cannot be read without the input
+			if (size > max_input_size)
+				return respond_error(*connection, request_number, "Input of " + std::to_string(size) + " bytes is larger than " + std::to_string(max_input_size));
+			auto input = std::string(size, '\0');
+			if (!connection->read_exactly(input.data(), size))
+				return;
+			++num_solving;
+			pool.submit([this, connection, request_number, name = std::move(name), input = std::move(input)]
+			{
+				solve(*connection, request_number, name, input);
+				if (--num_solving == 0)
+					num_solving.notify_all();
+			});
+		}
+	}
+
+	void solve(Connection& connection, int request_number, const std::string& name, const std::string& input)
+	{
+		const auto solver = solvers.find(name);
+		if (solver == solvers.end())
+			return respond_error(connection, request_number, "Unknown test " + name);
+		const auto key = ResultCache::Key{name, content_hash(input)};
+		if (cache)
+			if (const auto entry = cache->find(key))
+				return respond(connection, request_number, entry->statistics.median, entry->answer);
+		try
+		{
+			auto is = std::ispanstream{std::span<const char>{input}};
+			const auto start = std::chrono::steady_clock::now();
+			const auto answer = [&]
+			{
+				const auto arena_scope = ArenaScope{};
+				return solver->second(is);
+			}();
+			const auto duration = Statistics::Duration{std::chrono::steady_clock::now() - start};
+			if (cache)
+			{
+				cache->store(key, {answer, Statistics::from({std::chrono::duration_cast<std::chrono::nanoseconds>(duration)})});
+				// rewriting the whole file for every answer would take longer
+				// than most solvers
+				if (++num_unsaved % save_interval == 0)
+					cache->save();
+			}
+			respond(connection, request_number, duration, answer);
+		}
+		catch (const std::exception& e)
+		{
+			respond_error(connection, request_number, e.what());
+		}
+	}
+
+	static void respond(Connection& connection, int request_number, Statistics::Duration duration, std::string_view answer)
+	{
+		connection.write_response(
+			std::to_string(request_number) + " ok " + std::to_string(std::lround(duration.count())) + ' ' + std::to_string(answer.size()) + '\n',
+			answer);
+	}
+
+	static void respond_error(Connection& connection, int request_number, std::string_view message)
+	{
+		connection.write_response(std::to_string(request_number) + " error " + std::to_string(message.size()) + '\n', message);
+	}
+
+	std::map<std::string, Solver, std::less<>> solvers;
+	ThreadPool pool;
+	ResultCache* cache;
+	// saved every save_interval answers and when the server stops
+	static constexpr auto save_interval = 64;
+	std::atomic<int> num_unsaved = 0;
+	// only used by the thread that serves
+	std::vector<Reader> readers;
+	// requests that were read but not answered yet
+	std::atomic<int> num_solving = 0;
+	std::atomic<bool> stopping = false;
+	static inline volatile std::sig_atomic_t stop_requested = 0;
+};
@@ -0,0 +1,107 @@
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <future>
+#include <iostream>
+#include <istream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include "server.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+// Stops a server while a client is still connected, which must not hang or
+// leave the socket behind.
+//
+//   AoC2021_server_test
+
+
+namespace
+{
+
+
+	void check(bool condition, std::string_view what)
+	{
+		if (!condition)
+			throw std::runtime_error("Failed: " + std::string{what});
+	}
+
+
+	int connect_to(const std::filesystem::path& socket_path)
+	{
+		const auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		auto address = sockaddr_un{};
+		address.sun_family = AF_UNIX;
+		socket_path.native().copy(address.sun_path, sizeof(address.sun_path) - 1);
+		// the server may not be listening yet
+		for (auto attempt = 0; attempt < 100; ++attempt)
+			if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0)
+				return fd;
+			else
+				std::this_thread::sleep_for(std::chrono::milliseconds{20});
+		close(fd);
+		throw std::runtime_error("Could not connect to " + socket_path.string());
+	}
+
+
+	// up to and without the newline, empty when the connection is closed
+	std::string read_line(int fd)
+	{
+		auto line = std::string{};
+		for (char c = 0; read(fd, &c, 1) == 1 && c != '\n';)
+			line += c;
+		return line;
+	}
+
+
+}
+
+
+int main()
+{
+	using namespace std::literals;
+	const auto socket_path = std::filesystem::temp_directory_path() / ("aoc_server_test." + std::to_string(getpid()));
+	auto solvers = std::map<std::string, SolverServer::Solver, std::less<>>{};
+	solvers.emplace("size", [](std::istream& is)
+	{
+		return std::to_string(std::distance(std::istreambuf_iterator<char>{is}, std::istreambuf_iterator<char>{}));
+	});
+	try
+	{
+		auto server = SolverServer(std::move(solvers), 2, nullptr);
+		auto serving = std::async(std::launch::async, [&] { server.serve(socket_path); });
+		const auto client = connect_to(socket_path);
+		const auto request = "size 5\nhello"sv;
+		check(write(client, request.data(), request.size()) == std::ssize(request), "sending a request");
+		const auto header = read_line(client);
+		char answer = 0;
+		check(header.starts_with("0 ok ") && header.ends_with(" 1") && read(client, &answer, 1) == 1 && answer == '5', "answering a request");
+
+		// the client stays connected, its reader is waiting for the next request
+		server.stop();
+		if (serving.wait_for(5s) != std::future_status::ready)
+		{
+			// the server cannot be destroyed while it is still serving
+			std::cerr << "Failed: stopping with a client connected" << std::endl;
+			std::filesystem::remove(socket_path);
+			std::_Exit(1);
+		}
+		serving.get();
+		check(!std::filesystem::exists(socket_path), "removing the socket");
+		check(read_line(client).empty(), "shutting down the connection");
+		close(client);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		std::filesystem::remove(socket_path);
+		return 1;
+	}
+	std::cout << "Server test passed" << std::endl;
+}
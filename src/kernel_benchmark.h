@@ -0,0 +1,47 @@
+#pragma once
+#include <functional>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+// Benchmarks of the building blocks of a solver, run by AoC2021_bench.
+// They are registered from a solver's source file in an AOC_BENCH section,
+// so they can use the types in its anonymous namespace.
+//
+// set_up() prepares the data from the input file and returns the kernel,
+// a kernel call returns the number of operations it performed, so timings
+// are reported per operation.
+struct KernelBenchmark
+{
+	using Kernel = std::function<int()>;
+
+	std::string name;
+	std::string input;
+	std::function<Kernel(std::istream&)> set_up;
+};
+
+
+inline std::vector<KernelBenchmark>& kernel_benchmarks()
+{
+	static auto benchmarks = std::vector<KernelBenchmark>{};
+	return benchmarks;
+}
+
+
+struct RegisterKernelBenchmark
+{
+	explicit RegisterKernelBenchmark(std::string_view name, std::string_view input, auto&& set_up)
+	{
+		kernel_benchmarks().push_back(KernelBenchmark{std::string{name}, std::string{input}, set_up});
+	}
+};
+
+
+// keeps the compiler from optimising away a result that is not used
+template<typename T>
+void do_not_optimize(const T& value)
+{
+	asm volatile("" : : "r,m"(value) : "memory");
+}
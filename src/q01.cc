@@ -1,7 +1,12 @@
 #include <algorithm>
+#include <bit>
+#include <cstddef>
 #include <istream>
-#include <ranges>
+#include <memory_resource>
+#include <stdexcept>
 #include <vector>
+#include "kernel_benchmark.h"
+#include "registry.h"
 #include "util.h"
 
 
@@ -9,14 +14,83 @@ namespace
 {
 
 
-	void for_each_zipped(auto&& range1, auto&& range2, auto&& pred)
+	// Number of i < size with current[i] > previous[i]. Uses AVX2 when the
+	// compiler targets it.
+	int count_increases(const int* previous, const int* current, std::ptrdiff_t size)
 	{
-		using std::begin;
-		using std::end;
-		auto c1 = begin(range1);
-		auto c2 = begin(range2);
-		for (; c1 != end(range1) && c2 != end(range2); ++c1, ++c2)
-			pred(*c1, *c2);
+		auto count = 0;
+		auto i = std::ptrdiff_t{0};
+#if defined(__AVX2__)
+		for (; i + 8 <= size; i += 8)
+		{
+			const auto before = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(previous + i));
+			const auto after = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(current + i));
+			const auto increased = _mm256_cmpgt_epi32(after, before);
+			count += std::popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(increased))));
+		}
+#endif
+		for (; i < size; ++i)
+			count += current[i] > previous[i];
+		return count;
+	}
+
+
+	// Counts how often the sum of a sliding window increases, which is how
+	// often a value is bigger than the one window_size values before it
+	// (the values in between are in both sums). Only the last window_size
+	// values are kept, in front of the block of values being added, so the
+	// comparisons of a whole block are done at once.
+	class WindowIncreases
+	{
+	public:
+		explicit WindowIncreases(int window_size) :
+			window(window_size),
+			values(window_size + block_size, arena())
+		{
+		}
+
+		void add(int value)
+		{
+			values[filled++] = value;
+			if (filled == std::ssize(values))
+				flush();
+		}
+
+		int count()
+		{
+			flush();
+			if (num_compared == 0)
+				throw std::runtime_error("Not enough values");
+			return increases;
+		}
+
+	private:
+		static constexpr auto block_size = 4096;
+
+		void flush()
+		{
+			if (filled <= window)
+				return;
+			increases += count_increases(values.data(), values.data() + window, filled - window);
+			num_compared += filled - window;
+			std::copy(values.begin() + filled - window, values.begin() + filled, values.begin());
+			filled = window;
+		}
+
+		std::ptrdiff_t window;
+		std::pmr::vector<int> values;
+		std::ptrdiff_t filled = 0;
+		// all values but the first window_size
+		std::ptrdiff_t num_compared = 0;
+		int increases = 0;
+	};
+
+
+	int count_window_increases(std::istream& is, int window_size)
+	{
+		auto counter = WindowIncreases(window_size);
+		for_each_streamed<int>(is, [&](int value) { counter.add(value); });
+		return counter.count();
 	}
 
 
@@ -25,33 +99,35 @@ namespace
 
 int q01a(std::istream& is)
 {
-	auto count = 0;
-	auto input = std::ranges::istream_view<int>(is);
-	auto current = input.begin();
-	if (current == input.end())
-		throw std::runtime_error("Not enough values");
-	// go through the list without storing it (so no allocation)
-	auto previous = *current;
-	++current;
-	for (; current != input.end(); ++current)
-	{
-		if (*current > previous)
-			++count;
-		previous = *current;
-	}
-	return count;
+	return count_window_increases(is, 1);
 }
 
 
 int q01b(std::istream& is)
 {
-	auto numbers = read_non_separated<std::vector<int>>(is);
-	if (numbers.size() < 4)
-		throw std::runtime_error("Not enough values");
-	// only check if the number added to the sliding window is bigger than the number
-	auto numbers_offset = numbers | std::views::drop(3);
-	auto count = 0;
-	// zip_view is not in std yet
-	for_each_zipped(numbers, numbers_offset, [&](const auto& l, const auto& r) { if (r > l) ++count; });
-	return count;
+	return count_window_increases(is, 3);
+}
+
+
+const auto registration = RegisterSolvers{
+	{"01a", q01a, {{"q01.tst", 7}, {"q01.tst2", 1}, {"q01.tst3", 2}, {"q01.tst4", 2}, {"q01.inp"}}},
+	{"01b", q01b, {{"q01.tst", 5}, {"q01.tst3", 1}, {"q01.tst4", 1}, {"q01.inp"}}},
+};
+
+
+#ifdef AOC_BENCH
+namespace
+{
+	// compares every depth with the one three further
+	const auto bench_count_increases = RegisterKernelBenchmark("count_increases", "q01.inp", [](std::istream& is)
+	{
+		auto depths = std::vector<int>{};
+		for_each_streamed<int>(is, [&](int depth) { depths.push_back(depth); });
+		return [depths]()
+		{
+			do_not_optimize(count_increases(depths.data(), depths.data() + 3, std::ssize(depths) - 3));
+			return static_cast<int>(depths.size()) - 3;
+		};
+	});
 }
+#endif
@@ -1,102 +1,137 @@
 #include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <future>
 #include <istream>
-#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "registry.h"
 #include "util.h"
 
 
 namespace {
 
 
-	enum class Direction
+	// The first letter of a direction determines it, so it is decoded by a
+	// table lookup; the rest of the word is only checked, with the space
+	// after it.
+	struct DirectionCode
 	{
-		down,
-		forward,
-		up,
+		int forward;
+		int aim;
+		std::string_view word;
 	};
 
-	inline std::istream& operator>>(std::istream& is, Direction& direction)
+	constexpr auto direction_codes = []
 	{
-		const auto word = read<std::string>(is);
-		if (word == "down")
-			direction = Direction::down;
-		else if (word == "forward")
-			direction = Direction::forward;
-		else if (word == "up")
-			direction = Direction::up;
-		else if (is.good())
-			throw std::runtime_error("Unexpected direction: " + word);
-		return is;
-	}
+		auto codes = std::array<DirectionCode, 256>{};
+		codes['f'] = {1,  0, "forward "};
+		codes['d'] = {0,  1, "down "};
+		codes['u'] = {0, -1, "up "};
+		return codes;
+	}();
+
+
+	// What a part of the course does to the submarine, relative to where it
+	// started: with aim a at the start, it moves dx forward and a*dx + ddepth
+	// down, and its aim changes by daim. Summaries of consecutive parts
+	// compose, so the parts can be summarised in parallel.
+	//
+	// Without aim (part a), the depth changes like the aim does.
+	struct Summary
+	{
+		std::int64_t dx = 0;
+		std::int64_t ddepth = 0;
+		std::int64_t daim = 0;
 
+		bool operator==(const Summary&) const = default;
+	};
 
-	struct Instruction
+	Summary operator+(const Summary& first, const Summary& second)
 	{
-		Direction direction;
-		int x;
-	};
+		return Summary{
+			first.dx + second.dx,
+			first.ddepth + first.daim * second.dx + second.ddepth,
+			first.daim + second.daim};
+	}
+
 
-	inline std::istream& operator>>(std::istream& is, Instruction& instruction)
+	Summary summarise(std::string_view course)
 	{
-		is >> instruction.direction >> instruction.x;
-		return is;
+		auto summary = Summary{};
+		auto scanner = Scanner(course);
+		while (scanner.has_more())
+		{
+			const auto code = direction_codes[static_cast<unsigned char>(scanner.peek())];
+			if (code.word.empty() || !scanner.remaining().starts_with(code.word))
+				throw std::runtime_error("Unexpected direction: " + std::string{scanner.word()});
+			scanner.skip(code.word.size());
+			const auto x = scanner.number<int>();
+			summary.ddepth += summary.daim * code.forward * x;
+			summary.dx += code.forward * x;
+			summary.daim += code.aim * x;
+		}
+		return summary;
 	}
 
 
-	struct Position
+	// Splits the course at line ends into num_parts parts, which are
+	// summarised in parallel. Parts can be empty.
+	Summary summarise_in_parts(std::string_view course, std::size_t num_parts)
 	{
-		int x;
-		int depth;
-		int aim = 0;
-	};
+		auto parts = std::vector<std::future<Summary>>{};
+		auto begin = std::size_t{0};
+		for (auto i = std::size_t{1}; i < num_parts; ++i)
+		{
+			const auto end = std::min(course.find('\n', std::max(begin, i * course.size() / num_parts)), course.size());
+			parts.push_back(std::async(std::launch::async, summarise, course.substr(begin, end - begin)));
+			begin = end;
+		}
+		const auto last_part = summarise(course.substr(begin));
+		auto summary = Summary{};
+		for (auto& part: parts)
+			summary = summary + part.get();
+		return summary + last_part;
+	}
 
 
+	// A part per thread, but not parts so small that starting a thread costs
+	// more than it saves. That is never more than one part for the examples,
+	// so with assertions they are also split at every line, which has to give
+	// the same summary.
+	Summary summarise_in_parallel(std::string_view course)
+	{
+		constexpr auto min_part_size = std::size_t{1} << 20;
+		const auto num_parts = std::clamp<std::size_t>(course.size() / min_part_size, 1, std::max(std::thread::hardware_concurrency(), 1u));
+		const auto summary = summarise_in_parts(course, num_parts);
+		assert(course.size() > 1000 || summary == summarise_in_parts(course, std::ranges::count(course, '\n') + 1));
+		return summary;
+	}
+
 }
 
 
-int q02a(std::istream& is)
+std::int64_t q02a(std::istream& is)
 {
-	auto pos = Position{0, 0};
-	auto move = [&pos](const Instruction& instruction)
-	{
-		switch (instruction.direction)
-		{
-		case Direction::down:
-			pos.depth += instruction.x;
-			break;
-		case Direction::forward:
-			pos.x += instruction.x;
-			break;
-		case Direction::up:
-			pos.depth -= instruction.x;
-			break;
-		}
-	};
-	auto instructions = std::ranges::istream_view<Instruction>(is);
-	std::ranges::for_each(instructions, move);
-	return pos.x * pos.depth;
+	const auto input = InputBuffer(is);
+	const auto summary = summarise_in_parallel(input.view());
+	return summary.dx * summary.daim;
 }
 
 
-int q02b(std::istream& is)
+std::int64_t q02b(std::istream& is)
 {
-	auto pos = Position{0, 0, 0};
-	auto move = [&pos](const Instruction& instruction)
-	{
-		switch (instruction.direction)
-		{
-		case Direction::down:
-			pos.aim += instruction.x;
-			break;
-		case Direction::forward:
-			pos.x += instruction.x;
-			pos.depth += pos.aim * instruction.x;
-			break;
-		case Direction::up:
-			pos.aim -= instruction.x;
-			break;
-		}
-	};
-	auto instructions = std::ranges::istream_view<Instruction>(is);
-	std::ranges::for_each(instructions, move);
-	return pos.x * pos.depth;
+	const auto input = InputBuffer(is);
+	const auto summary = summarise_in_parallel(input.view());
+	return summary.dx * summary.ddepth;
 }
+
+
+const auto registration = RegisterSolvers{
+	{"02a", q02a, {{"q02.tst", 150}, {"q02.inp"}}},
+	{"02b", q02b, {{"q02.tst", 900}, {"q02.inp"}}},
+};
@@ -1,95 +1,214 @@
 #include <algorithm>
-#include <bitset>
+#include <bit>
+#include <cstdint>
 #include <istream>
+#include <memory_resource>
 #include <ranges>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cassert>
+#include "registry.h"
 #include "util.h"
 
 
 namespace {
 
 
-	struct Bitset
+	// A number of any width, as 32 bit limbs with the least significant first.
+	using BigNumber = std::pmr::vector<std::uint32_t>;
+
+	std::string to_decimal(BigNumber number)
 	{
-		std::bitset<31> bits;
-		int num_bits;
-	};
+		auto groups = std::pmr::vector<std::uint32_t>{arena()};
+		while (!number.empty())
+		{
+			auto remainder = std::uint64_t{0};
+			for (auto& limb: number | std::views::reverse)
+			{
+				const auto value = (remainder << 32) | limb;
+				limb = static_cast<std::uint32_t>(value / 1'000'000'000);
+				remainder = value % 1'000'000'000;
+			}
+			groups.push_back(static_cast<std::uint32_t>(remainder));
+			while (!number.empty() && number.back() == 0)
+				number.pop_back();
+		}
+		if (groups.empty())
+			return "0";
+		auto result = std::to_string(groups.back());
+		for (const auto group: groups | std::views::reverse | std::views::drop(1))
+		{
+			const auto digits = std::to_string(group);
+			result += std::string(9 - digits.size(), '0') + digits;
+		}
+		return result;
+	}
 
-	std::istream& operator>>(std::istream& is, Bitset& bitset)
+	std::string multiply(const BigNumber& a, const BigNumber& b)
 	{
-		const auto s = read<std::string>(is);
-		if (s.size() > bitset.bits.size())
-			throw std::runtime_error("Too many bits");
-		bitset.num_bits = s.size();
-		bitset.bits = std::bitset<31>(s);
-		return is;
+		auto product = BigNumber(a.size() + b.size(), arena());
+		for (auto i = 0u; i < a.size(); ++i)
+		{
+			auto carry = std::uint64_t{0};
+			for (auto j = 0u; j < b.size(); ++j)
+			{
+				const auto value = std::uint64_t{a[i]} * b[j] + product[i+j] + carry;
+				product[i+j] = static_cast<std::uint32_t>(value);
+				carry = value >> 32;
+			}
+			product[i + b.size()] = static_cast<std::uint32_t>(carry);
+		}
+		return to_decimal(std::move(product));
 	}
 
 
-	auto find_most_common_bits(const auto& inputs)
+	// The report transposed: every column is a packed bit vector with a bit
+	// per line, so the ones in a column are counted by a popcount per 64
+	// lines. Lines can be of any width.
+	class BitColumns
 	{
-		auto bits = 0;
-		for (int i = inputs[0].num_bits - 1; i >= 0; --i)
+	public:
+		explicit BitColumns(std::string_view report)
 		{
-			const auto num_ones = std::ranges::count_if(
-				inputs,
-				[&](const auto& input)
+			auto scanner = Scanner(report);
+			if (!scanner.has_more())
+				throw std::runtime_error("Empty report");
+			const auto max_lines = std::ranges::count(scanner.remaining(), '\n') + 1;
+			words_per_column = (max_lines + 63) / 64;
+			for (; scanner.has_more(); ++num_lines)
+			{
+				const auto line = scanner.line();
+				if (num_lines == 0)
+				{
+					num_columns = std::ssize(line);
+					bits.resize(num_columns * words_per_column);
+				}
+				else if (std::ssize(line) != num_columns)
+					throw std::runtime_error("Lines differ in width");
+				for (auto column = 0; column < num_columns; ++column)
 				{
-					return input.bits[i] == 1;
-				});
-			bits = (bits << 1) | (2*num_ones < std::ssize(inputs));
+					const auto bit = static_cast<unsigned>(line[column] - '0');
+					if (bit > 1)
+						throw std::runtime_error("Expected a bit, found \"" + std::string{line[column]} + "\"");
+					bits[column * words_per_column + num_lines / 64] |= std::uint64_t{bit} << (num_lines % 64);
+				}
+			}
+		}
+
+		int width() const { return num_columns; }
+		std::int64_t size() const { return num_lines; }
+
+		std::int64_t count_ones(int column) const
+		{
+			const auto words = std::span{bits}.subspan(column * words_per_column, words_per_column);
+			return accumulate(words, std::int64_t{0}, [](std::int64_t count, std::uint64_t word) { return count + std::popcount(word); });
+		}
+
+	private:
+		int num_columns = 0;
+		std::int64_t num_lines = 0;
+		std::int64_t words_per_column = 0;
+		std::pmr::vector<std::uint64_t> bits{arena()};
+	};
+
+
+	BigNumber from_binary(std::string_view digits)
+	{
+		auto number = BigNumber((digits.size() + 31) / 32, arena());
+		for (auto i = 0u; i < digits.size(); ++i)
+		{
+			const auto bit = digits.size() - 1 - i;
+			number[bit / 32] |= static_cast<std::uint32_t>(digits[i] == '1') << (bit % 32);
 		}
-		return bits;
+		return number;
 	}
 
 
-	auto find_best_match(auto inputs, bool keep_one)
+	// The lines of the report, sorted. Lines of equal width sort like the
+	// numbers they are, so the lines that share the first bits form a range
+	// that is sorted by the next bit.
+	std::pmr::vector<std::string_view> read_sorted_lines(std::string_view report)
 	{
-		auto inputs_tmp	= decltype(inputs){};
-		for (int i = inputs[0].num_bits - 1; i >= 0; --i)
+		auto lines = std::pmr::vector<std::string_view>{arena()};
+		auto scanner = Scanner(report);
+		while (scanner.has_more())
 		{
-			const auto count = std::ranges::count_if(
-				inputs,
-				[&](const auto& input)
-				{
-					return input.bits[i] == 1;
-				});
-			const bool expected_value = keep_one ^ (2*count < std::ssize(inputs));
-			std::ranges::copy_if(
-				inputs,
-				std::back_inserter(inputs_tmp),
-				[&](const auto& input)
-				{
-					return input.bits[i] == expected_value;
-				});
-			std::swap(inputs, inputs_tmp);
-			inputs_tmp.clear();
-			if (inputs.size() == 1)
-				return inputs[0];
+			const auto line = scanner.line();
+			if (!lines.empty() && line.size() != lines.front().size())
+				throw std::runtime_error("Lines differ in width");
+			if (const auto not_a_bit = line.find_first_not_of("01"); not_a_bit != line.npos)
+				throw std::runtime_error("Expected a bit, found \"" + std::string{line[not_a_bit]} + "\"");
+			lines.push_back(line);
 		}
-		throw std::runtime_error("Could not find best match");
+		if (lines.empty())
+			throw std::runtime_error("Empty report");
+		std::ranges::sort(lines);
+		return lines;
 	}
 
 
+	// Narrows the range of candidates a bit at a time by a binary search for
+	// where the ones start, without moving any of them.
+	std::string_view find_best_match(std::span<const std::string_view> lines, bool keep_one)
+	{
+		const auto width = lines.front().size();
+		auto candidates = lines;
+		for (auto i = 0u; i < width && candidates.size() > 1; ++i)
+		{
+			const auto first_one = std::ranges::partition_point(candidates, [&](std::string_view line) { return line[i] == '0'; });
+			const auto num_zeros = first_one - candidates.begin();
+			const auto num_ones = candidates.end() - first_one;
+			const bool expected_value = keep_one ^ (num_ones < num_zeros);
+			candidates = expected_value ? candidates.subspan(num_zeros) : candidates.first(num_zeros);
+		}
+		// empty when all candidates agree on a bit that only a minority may have
+		if (candidates.empty() || candidates.size() > 1)
+			throw std::runtime_error("Could not find best match");
+		return candidates.front();
+	}
+
 }
 
 
-int q03a(std::istream& is)
+std::string q03a(std::istream& is)
 {
-	auto inputs = read_non_separated<std::vector<Bitset>>(is);
-	const auto gamma = find_most_common_bits(inputs);
-	const auto epsilon = (1 << inputs[0].num_bits) - 1 - gamma;
-	return gamma * epsilon;
+	const auto input = InputBuffer(is);
+	const auto columns = BitColumns(input.view());
+	mark_parsed();
+	auto gamma = BigNumber((columns.width() + 31) / 32, arena());
+	auto epsilon = BigNumber((columns.width() + 31) / 32, arena());
+	for (auto column = 0; column < columns.width(); ++column)
+	{
+		const auto bit = columns.width() - 1 - column;
+		// a tied column goes with the ones that have more ones
+		const auto more_ones = 2*columns.count_ones(column) >= columns.size();
+		(more_ones ? gamma : epsilon)[bit / 32] |= 1u << (bit % 32);
+	}
+	return multiply(gamma, epsilon);
 }
 
 
-int q03b(std::istream& is)
+std::string q03b(std::istream& is)
 {
-	auto inputs = read_non_separated<std::vector<Bitset>>(is);
-	const auto oxygen_generator_rating = find_best_match(inputs, true).bits.to_ulong();
-	const auto co2_scrubber_rating = find_best_match(inputs, false).bits.to_ulong();
-	return oxygen_generator_rating * co2_scrubber_rating;
+	const auto input = InputBuffer(is);
+	const auto lines = read_sorted_lines(input.view());
+	mark_parsed();
+	const auto oxygen_generator_rating = from_binary(find_best_match(lines, true));
+	const auto co2_scrubber_rating = from_binary(find_best_match(lines, false));
+	return multiply(oxygen_generator_rating, co2_scrubber_rating);
 }
+
+
+const auto registration = RegisterSolvers{
+	{"03a", q03a, {
+		{"q03.tst", std::string{"198"}},
+		{"q03.tst2", std::string{"454892443213676103535788031208453138818737333935849691163633119569410993132250"}},
+		{"q03.inp"}}},
+	{"03b", q03b, {
+		{"q03.tst", std::string{"230"}},
+		{"q03.tst2", std::string{"380937003067984761441712463713363315844251735314358330463218929796510758103904"}},
+		{"q03.inp"}}},
+};
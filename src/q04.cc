@@ -1,116 +1,139 @@
 #include <algorithm>
 #include <array>
-#include <bitset>
+#include <functional>
 #include <istream>
-#include <ranges>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <stdexcept>
+#include <string>
 #include <vector>
-#include <cassert>
+#include "registry.h"
 #include "util.h"
 
 
 namespace {
 
 
-	struct Number
+	// The turn on which every number is drawn, so a board does not have to
+	// be marked draw by draw.
+	class DrawTurns
 	{
-		std::int8_t n;
+	public:
+		// after all turns
+		static constexpr auto never = std::numeric_limits<int>::max();
+		// the turns are a table indexed by number
+		static constexpr auto max_number = 1 << 20;
 
-		constexpr auto operator<=>(const Number&) const = default;
-	};
+		explicit DrawTurns(Scanner& scanner)
+		{
+			for_each_separated<int>(scanner, [&](int number)
+			{
+				if (number < 0 || number > max_number)
+					throw std::runtime_error("Drawn number " + std::to_string(number) + " is not in [0, " + std::to_string(max_number) + "]");
+				if (number >= std::ssize(turns))
+					turns.resize(number + 1, never);
+				turns[number] = std::min(turns[number], static_cast<int>(std::ssize(draws)));
+				draws.push_back(number);
+			});
+		}
 
-	std::istream& operator>>(std::istream& is, Number& number)
-	{
-		is >> NotChar(number.n);
-		return is;
-	}
+		// numbers on the boards can be any number, even one that cannot be drawn
+		int turn_of(int number) const { return (number >= 0 && number < std::ssize(turns)) ? turns[number] : never; }
+		int number_at(int turn) const { return draws[turn]; }
+
+	private:
+		std::pmr::vector<int> turns{arena()};
+		std::pmr::vector<int> draws{arena()};
+	};
 
 
 	struct Board
 	{
-		bool stripe(Number number)
+		// A row or column is complete on the turn its last number is drawn,
+		// the board wins with the first of them.
+		int win_turn(const DrawTurns& draw_turns) const
 		{
-			if (const auto place = std::ranges::find(places, number); place == places.end())
-				return false;
-			else
+			auto turns = std::array<int, 25>{};
+			std::ranges::transform(places, turns.begin(), [&](int place) { return draw_turns.turn_of(place); });
+			auto win = DrawTurns::never;
+			for (auto i = 0; i < 5; ++i)
 			{
-				const auto index = std::distance(places.begin(), place);
-				marked.set(index);
-				const auto row = index / 5;
-				const auto col = index % 5;
-				return bingo_row(row) || bingo_col(col);
+				auto row = 0;
+				auto col = 0;
+				for (auto j = 0; j < 5; ++j)
+				{
+					row = std::max(row, turns[5*i + j]);
+					col = std::max(col, turns[5*j + i]);
+				}
+				win = std::min({win, row, col});
 			}
+			return win;
 		}
 
-		int sum_unmarked() const
-		{
-			auto sum = 0;
-			for (auto i = 0; i < std::ssize(places); ++i)
-				if (!marked.test(i))
-					sum += places[i].n;
-			return sum;
-		}
-
-		friend std::istream& operator>>(std::istream& is, Board& board)
+		// the numbers that are not drawn yet, times the one it won with
+		int score(int win_turn, const DrawTurns& draw_turns) const
 		{
-			for (auto i = 0; i < std::ssize(board.places); ++i)
-				is >> NotChar(board.places[i].n);
-			return is;
+			auto sum_unmarked = 0;
+			for (const auto place: places)
+				if (draw_turns.turn_of(place) > win_turn)
+					sum_unmarked += place;
+			return draw_turns.number_at(win_turn) * sum_unmarked;
 		}
 
-	private:
-		bool bingo_row(int row) const
-		{
-			constexpr auto single_row = 0b11111;
-			return ((marked >> (5*row)).to_ulong() & single_row) == single_row;
-		}
-		bool bingo_col(int col) const
+		friend Scanner& operator>>(Scanner& scanner, Board& board)
 		{
-			constexpr auto single_col = 0b00001'00001'00001'00001'00001;
-			return ((marked >> col).to_ulong() & single_col) == single_col;
+			for (auto& place: board.places)
+				place = scanner.number<int>();
+			return scanner;
 		}
 
-		std::array<Number, 25> places;
-		std::bitset<25> marked;
+		std::array<int, 25> places;
 	};
 
 
+	// Every board is scored by the turn it wins on while it is read, without
+	// playing the draws. replaces(turn, winning_turn) tells whether a board
+	// that wins on turn replaces the winner so far. A board that never wins
+	// can be the winner too, which gives -1 like it did when playing.
+	int play(std::istream& is, auto&& replaces)
+	{
+		const auto input = InputBuffer(is);
+		auto scanner = Scanner(input.view());
+		const auto draw_turns = DrawTurns(scanner);
+		auto winner = std::optional<Board>{};
+		auto winning_turn = DrawTurns::never;
+		for_each_read<Board>(scanner, [&](const Board& board)
+		{
+			const auto turn = board.win_turn(draw_turns);
+			if (!winner || replaces(turn, winning_turn))
+			{
+				winner = board;
+				winning_turn = turn;
+			}
+		});
+		return (winner && winning_turn != DrawTurns::never) ? winner->score(winning_turn, draw_turns) : -1;
+	}
+
+
 }
 
 
 int q04a(std::istream& is)
 {
-	const auto numbers = read_separated<std::vector<Number>>(is);
-	auto boards = read_non_separated<std::vector<Board>>(is);
-	for (auto number: numbers)
-	{
-		for (auto& board: boards)
-			if (board.stripe(number))
-				// first board that wins, return score
-				return number.n * board.sum_unmarked();
-	}
-	return -1;
+	// the first board wins a tie
+	return play(is, std::less<>{});
 }
 
 
 int q04b(std::istream& is)
 {
-	const auto numbers = read_separated<std::vector<Number>>(is);
-	auto boards = read_non_separated<std::vector<Board>>(is);
-	for (auto number: numbers)
-	{
-		for (auto it = boards.begin(); it != boards.end();)
-		{
-			if (it->stripe(number))
-			{
-				if (boards.size() == 1)
-					// last board that wins, return score
-					return number.n * it->sum_unmarked();
-				else
-					it = boards.erase(it);
-			}
-			else
-				++it;
-		}
-	}
-	return -1;
+	// the last board loses a tie, and no board is last when one never wins
+	return play(is, std::greater_equal<>{});
 }
+
+
+const auto registration = RegisterSolvers{
+	{"04a", q04a, {{"q04.tst", 4512}, {"q04.tst2", 4480}, {"q04.tst3", 4512}, {"q04.inp"}}},
+	{"04b", q04b, {{"q04.tst", 1924}, {"q04.tst2", 3360}, {"q04.tst3", -1}, {"q04.inp"}}},
+};
@@ -2,6 +2,7 @@
 #include <istream>
 #include <ranges>
 #include <vector>
+#include "registry.h"
 #include "util.h"
 
 
@@ -21,13 +22,6 @@ namespace {
 		}
 	};
 
-	std::istream& operator>>(std::istream& is, Point& point)
-	{
-		is >> point.x >> Assert{','} >> point.y;
-		return is;
-	}
-
-
 	struct Line
 	{
 		Point start;
@@ -45,10 +39,10 @@ namespace {
 		}
 	};
 
-	std::istream& operator>>(std::istream& is, Line& line)
+	Scanner& operator>>(Scanner& scanner, Line& line)
 	{
-		is >> line.start >> Assert(" ->") >> line.end;
-		return is;
+		scan<"{},{} -> {},{}">(scanner, line.start.x, line.start.y, line.end.x, line.end.y);
+		return scanner;
 	}
 
 
@@ -94,20 +88,29 @@ namespace {
 
 int q05a(std::istream& is)
 {
+	const auto input = InputBuffer(is);
+	auto scanner = Scanner(input.view());
 	auto board = Board<1024>{};
-	std::ranges::for_each(
-		std::ranges::istream_view<Line>(is)
-		| std::views::filter([](auto&& e) { const auto d = e.direction(); return d.x == 0 || d.y == 0; }),
-		[&](auto&& line) { board.mark(line); });
+	for_each_read<Line>(scanner, [&](auto&& line)
+	{
+		if (const auto d = line.direction(); d.x == 0 || d.y == 0)
+			board.mark(line);
+	});
 	return board.count_squares_used_multiple_times();
 }
 
 
 int q05b(std::istream& is)
 {
+	const auto input = InputBuffer(is);
+	auto scanner = Scanner(input.view());
 	auto board = Board<1024>{};
-	std::ranges::for_each(
-		std::ranges::istream_view<Line>(is),
-		[&](auto&& line) { board.mark(line); });
+	for_each_read<Line>(scanner, [&](auto&& line) { board.mark(line); });
 	return board.count_squares_used_multiple_times();
 }
+
+
+const auto registration = RegisterSolvers{
+	{"05a", q05a, {{"q05.tst", 5}, {"q05.inp"}}},
+	{"05b", q05b, {{"q05.tst", 12}, {"q05.inp"}}},
+};
@@ -2,6 +2,7 @@
 #include <array>
 #include <istream>
 #include <ranges>
+#include "registry.h"
 #include "util.h"
 
 
@@ -27,20 +28,14 @@ namespace {
 	template<typename T, int size>
 	auto read_fish(std::istream& is, RotatableArray<T, size>& population)
 	{
-		for (;;)
+		const auto input = InputBuffer(is);
+		auto scanner = Scanner(input.view());
+		for_each_separated<int>(scanner, [&](int timer)
 		{
-			const auto timer = read<int>(is);
-			++population[timer];
-			switch (is.get())
-			{
-			case '\n':
-				return;
-			case ',':
-				break;
-			default:
+			if (timer < 0 || timer >= size)
 				throw std::runtime_error("Could not parse population");
-			}
-		}
+			++population[timer];
+		});
 	}
 
 
@@ -51,6 +46,7 @@ int q06a(std::istream& is)
 {
 	auto population = RotatableArray<std::int64_t, 9>{};
 	read_fish(is, population);
+	mark_parsed();
 	for (auto i = 0; i < 80; ++i)
 	{
 		population.rotate();
@@ -64,6 +60,7 @@ std::int64_t q06b(std::istream& is)
 {
 	auto population = RotatableArray<std::int64_t, 9>{};
 	read_fish(is, population);
+	mark_parsed();
 	for (auto i = 0; i < 256; ++i)
 	{
 		population.rotate();
@@ -71,3 +68,9 @@ std::int64_t q06b(std::istream& is)
 	}
 	return population.sum();
 }
+
+
+const auto registration = RegisterSolvers{
+	{"06a", q06a, {{"q06.tst", 5934}, {"q06.inp"}}},
+	{"06b", q06b, {{"q06.tst", 26984457539}, {"q06.inp"}}},
+};
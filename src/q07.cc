@@ -2,12 +2,16 @@
 #include <istream>
 #include <ranges>
 #include <vector>
+#include "registry.h"
 #include "util.h"
 
 
 int q07a(std::istream& is)
 {
-	auto positions = read_separated<std::vector<int>>(is);
+	const auto input = InputBuffer(is);
+	auto scanner = Scanner(input.view());
+	auto positions = read_separated<std::vector<int>>(scanner);
+	mark_parsed();
 	std::ranges::nth_element(positions, positions.begin() + positions.size()/2);
 	const auto position = positions[positions.size()/2];
 	auto fuel_cost = [&](auto&& pos)
@@ -23,7 +27,10 @@ int q07a(std::istream& is)
 
 int q07b(std::istream& is)
 {
-	auto positions = read_separated<std::vector<int>>(is);
+	const auto input = InputBuffer(is);
+	auto scanner = Scanner(input.view());
+	auto positions = read_separated<std::vector<int>>(scanner);
+	mark_parsed();
 	auto total_fuel_cost = [&positions](const auto& pos)
 	{
 		auto fuel_cost = [&pos](const auto& p)
@@ -51,3 +58,9 @@ int q07b(std::istream& is)
 	}
 	return total_fuel_cost(min);
 }
+
+
+const auto registration = RegisterSolvers{
+	{"07a", q07a, {{"q07.tst", 37}, {"q07.inp"}}},
+	{"07b", q07b, {{"q07.tst", 168}, {"q07.inp"}}},
+};
@@ -5,6 +5,7 @@
 #include <ranges>
 #include <string>
 #include <cassert>
+#include "registry.h"
 #include "util.h"
 
 
@@ -111,3 +112,9 @@ int q08b(std::istream& is)
 				}),
 		0);
 }
+
+
+const auto registration = RegisterSolvers{
+	{"08a", q08a, {{"q08.tst", 26}, {"q08.inp"}}},
+	{"08b", q08b, {{"q08.tst", 61229}, {"q08.inp"}}},
+};
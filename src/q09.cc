@@ -1,9 +1,11 @@
 #include <array>
 #include <algorithm>
 #include <istream>
+#include <memory_resource>
 #include <ranges>
 #include <vector>
 #include <cassert>
+#include "registry.h"
 #include "util.h"
 
 
@@ -86,6 +88,7 @@ namespace {
 int q09a(std::istream& is)
 {
 	const auto map = HeightMap::read(is);
+	mark_parsed();
 	auto low_points = std::vector<HeightMap::Pos>{};
 	for (auto pos = map.get_top_left(); pos < map.get_bottom_right(); ++pos)
 		if (map.is_lower_than_neighbours(pos))
@@ -97,7 +100,8 @@ int q09a(std::istream& is)
 int q09b(std::istream& is)
 {
 	auto map = HeightMap::read(is);
-	std::vector<int> basins;
+	mark_parsed();
+	auto basins = std::pmr::vector<int>{arena()};
 	for (auto pos = map.get_top_left(); pos < map.get_bottom_right(); ++pos)
 	{
 		const auto num_filled = map.fill_basin(pos);
@@ -108,3 +112,9 @@ int q09b(std::istream& is)
 	assert(basins.size() > 2);
 	return basins.at(0) * basins.at(1) * basins.at(2);
 }
+
+
+const auto registration = RegisterSolvers{
+	{"09a", q09a, {{"q09.tst", 15}, {"q09.inp"}}},
+	{"09b", q09b, {{"q09.tst", 1134}, {"q09.inp"}}},
+};
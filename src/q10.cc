@@ -2,6 +2,7 @@
 #include <iostream>
 #include <ranges>
 #include <vector>
+#include "registry.h"
 #include "util.h"
 
 
@@ -107,3 +108,9 @@ std::int64_t q10b(std::istream& is)
 	std::ranges::sort(scores);
 	return scores[scores.size()/2];
 }
+
+
+const auto registration = RegisterSolvers{
+	{"10a", q10a, {{"q10.tst", 26397}, {"q10.inp"}}},
+	{"10b", q10b, {{"q10.tst", 288957}, {"q10.inp"}}},
+};
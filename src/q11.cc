@@ -3,6 +3,7 @@
 #include <iostream>
 #include <ranges>
 #include <cassert>
+#include "registry.h"
 #include "util.h"
 
 
@@ -75,6 +76,7 @@ namespace
 int q11a(std::istream& is)
 {
 	auto grid = read<Grid>(is);
+	mark_parsed();
 	auto flashes = 0;
 	for (auto i = 0; i < 100; ++i)
 		flashes += grid.evolve();
@@ -85,7 +87,14 @@ int q11a(std::istream& is)
 int q11b(std::istream& is)
 {
 	auto grid = read<Grid>(is);
+	mark_parsed();
 	for (auto i = 1; ; ++i)
 		if (grid.evolve() == 100)
 			return i;
 }
+
+
+const auto registration = RegisterSolvers{
+	{"11a", q11a, {{"q11.tst", 1656}, {"q11.inp"}}},
+	{"11b", q11b, {{"q11.tst", 195}, {"q11.inp"}}},
+};
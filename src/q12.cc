@@ -1,8 +1,11 @@
 #include <algorithm>
 #include <istream>
+#include <memory_resource>
 #include <ranges>
 #include <string>
 #include <vector>
+#include "registry.h"
+#include "util.h"
 
 
 namespace
@@ -74,10 +77,11 @@ namespace
 		{
 			explicit Cave(std::string nm) :
 				name(std::move(nm)),
+				connections(arena()),
 				type(from_name(name))
 			{}
 			std::string name;
-			std::vector<std::int8_t> connections;
+			std::pmr::vector<std::int8_t> connections;
 			Type type;
 		};
 
@@ -108,12 +112,12 @@ namespace
 				break;
 			}
 		}
-		void count_paths_from(const std::vector<std::int8_t>& next_cave_indices, const bool allow_duplicate)
+		void count_paths_from(const std::pmr::vector<std::int8_t>& next_cave_indices, const bool allow_duplicate)
 		{
 			for (const auto& next_cave_index: next_cave_indices)
 				count_paths_from(caves[next_cave_index], allow_duplicate);
 		}
-		std::vector<Cave> caves;
+		std::pmr::vector<Cave> caves{arena()};
 		int num_paths;
 	};
 
@@ -137,3 +141,9 @@ int q12b(std::istream& is)
 		solver.add(tunnel);
 	return solver.find_paths(true);
 }
+
+
+const auto registration = RegisterSolvers{
+	{"12a", q12a, {{"q12.tst1", 10}, {"q12.tst2", 19}, {"q12.tst3", 226}, {"q12.inp"}}},
+	{"12b", q12b, {{"q12.tst1", 36}, {"q12.tst2", 103}, {"q12.tst3", 3509}, {"q12.inp"}}},
+};
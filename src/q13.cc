@@ -2,6 +2,7 @@
 #include <istream>
 #include <ranges>
 #include <vector>
+#include "registry.h"
 #include "util.h"
 
 
@@ -14,17 +15,17 @@ namespace
 		bool horizontally;
 	};
 
-	std::istream& operator>>(std::istream& is, Fold& fold)
+	Scanner& operator>>(Scanner& scanner, Fold& fold)
 	{
 		auto fold_orientation = char{};
-		is >> Assert("fold along ") >> fold_orientation >> Assert('=') >> fold.location >> Assert('\n');
+		scan<"fold along {}={}">(scanner, fold_orientation, fold.location);
 		switch (fold_orientation)
 		{
 		case 'x': fold.horizontally = true; break;
 		case 'y': fold.horizontally = false; break;
-		default : if (is.good()) throw std::runtime_error("Expected \"x\" or \"y\"");
+		default : throw std::runtime_error("Expected \"x\" or \"y\"");
 		}
-		return is;
+		return scanner;
 	}
 
 
@@ -65,15 +66,15 @@ namespace
 		}
 	};
 
-	std::istream& operator>>(std::istream& is, Sheet& sheet)
+	Scanner& operator>>(Scanner& scanner, Sheet& sheet)
 	{
 		sheet.dots.clear();
-		while (is.good() && is.peek() != '\n')
+		while (!scanner.at_end() && scanner.peek() != '\n')
 		{
 			auto& dot = sheet.dots.emplace_back();
-			is >> dot.x >> Assert{','} >> dot.y >> Assert{'\n'};
+			scan<"{},{}\n">(scanner, dot.x, dot.y);
 		}
-		return is;
+		return scanner;
 	}
 
 	std::ostream& operator<<(std::ostream& os, const Sheet& sheet)
@@ -97,9 +98,12 @@ namespace
 
 int q13a(std::istream& is)
 {
+	const auto input = InputBuffer(is);
+	auto scanner = Scanner(input.view());
 	auto sheet = Sheet{};
 	auto fold = Fold{};
-	is >> sheet >> Assert('\n') >> fold;
+	scanner >> sheet >> Assert('\n') >> fold;
+	mark_parsed();
 	sheet.apply(fold);
 	return sheet.dots.size();
 }
@@ -107,11 +111,26 @@ int q13a(std::istream& is)
 
 std::string q13b(std::istream& is)
 {
+	const auto input = InputBuffer(is);
+	auto scanner = Scanner(input.view());
 	auto sheet = Sheet{};
-	is >> sheet >> Assert('\n');
-	for (const auto& fold: std::ranges::istream_view<Fold>(is))
-		sheet.apply(fold);
+	scanner >> sheet >> Assert('\n');
+	for_each_read<Fold>(scanner, [&](const Fold& fold) { sheet.apply(fold); });
 	std::ostringstream os;
 	os << sheet;
 	return os.str();
 }
+
+
+const auto registration = RegisterSolvers{
+	{"13a", q13a, {{"q13.tst", 17}, {"q13.inp"}}},
+	{"13b", q13b, {
+		{"q13.tst", std::string{
+			"#####\n"
+			"#   #\n"
+			"#   #\n"
+			"#   #\n"
+			"#####\n"}},
+		{"q13.inp"},
+	}},
+};
@@ -4,6 +4,7 @@
 #include <map>
 #include <ranges>
 #include <string>
+#include "registry.h"
 #include "util.h"
 
 
@@ -91,6 +92,7 @@ int q14a(std::istream& is)
 	auto rules = Rules{};
 	is >> polymer_input >> Assert("\n\n") >> rules;
 	auto polymer = Polymer{std::move(polymer_input)};
+	mark_parsed();
 	for (auto i = 0; i < 10; ++i)
 		polymer.grow(rules);
 	auto occurrences = polymer.count_occurrences();
@@ -105,9 +107,16 @@ std::int64_t q14b(std::istream& is)
 	auto rules = Rules{};
 	is >> polymer_input >> Assert("\n\n") >> rules;
 	auto polymer = Polymer{std::move(polymer_input)};
+	mark_parsed();
 	for (auto i = 0; i < 40; ++i)
 		polymer.grow(rules);
 	auto occurrences = polymer.count_occurrences();
 	const auto& [min, max] = std::ranges::minmax_element(occurrences, std::ranges::less{}, &decltype(occurrences)::value_type::second);
 	return max->second - min->second;
 }
+
+
+const auto registration = RegisterSolvers{
+	{"14a", q14a, {{"q14.tst", 1588}, {"q14.inp"}}},
+	{"14b", q14b, {{"q14.tst", 2188189693529}, {"q14.inp"}}},
+};
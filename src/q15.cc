@@ -5,6 +5,9 @@
 #include <ranges>
 #include <vector>
 #include <cassert>
+#include "kernel_benchmark.h"
+#include "registry.h"
+#include "trace.h"
 #include "util.h"
 
 
@@ -92,13 +95,18 @@ namespace
 
 		auto solve()
 		{
+			TRACE_ZONE("q15 solve");
 			const auto all_directions = std::array<int, 4>{1, -1, positions.end().x, -positions.end().x};
 			auto total_risk_level = Grid<RiskLevel>(positions.end(), unknown_risk_level);
 			auto to_calculate = std::priority_queue<PendingPos, std::vector<PendingPos>, std::greater<>>{};
 			to_calculate.push({0, positions.to_index(Pos{1, 1})});
 			total_risk_level[positions.to_index(Pos{1,1})] = 0;
-			while (!to_calculate.empty())
+			// every position is popped about once
+			const auto num_positions = positions.end().x * positions.end().y;
+			for (auto num_popped = 1; !to_calculate.empty(); ++num_popped)
 			{
+				if (num_popped % 4096 == 0)
+					poll_cancellation(std::min(1.0, static_cast<double>(num_popped) / num_positions));
 				const auto risk_pos = to_calculate.top();
 				to_calculate.pop();
 				if (total_risk_level[risk_pos.pos] == risk_pos.total_risk_level)
@@ -123,6 +131,7 @@ namespace
 
 	auto read_grid(std::istream& is)
 	{
+		TRACE_ZONE("q15 parse");
 		auto result = std::vector<std::int8_t>{};
 		auto lines = 0;
 		std::noskipws(is);
@@ -144,6 +153,7 @@ namespace
 	template<typename T>
 	auto multiply(const Grid<T>& grid, int factor)
 	{
+		TRACE_ZONE("q15 multiply");
 		auto result = Grid<T>{grid.end()*factor, {}};
 		for (auto yi = 0; yi < factor; ++yi)
 			for (auto xi = 0; xi < factor; ++xi)
@@ -160,6 +170,7 @@ namespace
 int q15a(std::istream& is)
 {
 	const auto grid = read_grid(is);
+	mark_parsed();
 	auto solver = CavernSolver{grid};
 	const auto total_risk = solver.solve();
 	return total_risk;
@@ -169,8 +180,30 @@ int q15a(std::istream& is)
 int q15b(std::istream& is)
 {
 	const auto grid = read_grid(is);
+	mark_parsed();
 	const auto grid5 = multiply(grid, 5);
 	auto solver = CavernSolver{grid5};
 	const auto total_risk = solver.solve();
 	return total_risk;
 }
+
+
+const auto registration = RegisterSolvers{
+	{"15a", q15a, {{"q15.tst", 40}, {"q15.inp"}}},
+	{"15b", q15b, {{"q15.tst", 315}, {"q15.inp"}}, Cost::SLOW, std::chrono::seconds{1}},
+};
+
+
+#ifdef AOC_BENCH
+namespace
+{
+	const auto bench_solve = RegisterKernelBenchmark("CavernSolver::solve", "q15.inp", [](std::istream& is)
+	{
+		return [solver = CavernSolver{multiply(read_grid(is), 5)}]() mutable
+		{
+			do_not_optimize(solver.solve());
+			return 1;
+		};
+	});
+}
+#endif
@@ -1,8 +1,14 @@
 #include <algorithm>
 #include <istream>
+#include <memory_resource>
 #include <ranges>
+#include <span>
+#include <spanstream>
+#include <string>
 #include <vector>
 #include <cassert>
+#include "kernel_benchmark.h"
+#include "registry.h"
 #include "util.h"
 
 
@@ -106,7 +112,7 @@ namespace
 			return process_packet(header, read_literal(bit_reader));
 		else
 		{
-			auto sub_results = std::vector<ResultType>{};
+			auto sub_results = std::pmr::vector<ResultType>{arena()};
 			auto length_type_id = LengthTypeID{};
 			bit_reader.consume(1, length_type_id);
 			switch (length_type_id)
@@ -175,3 +181,34 @@ std::int64_t q16b(std::istream& is)
 		}
 	});
 }
+
+
+const auto registration = RegisterSolvers{
+	{"16a", q16a, {{"q16.tst", 16}, {"q16.inp"}}},
+	{"16b", q16b, {{"q16.tst", 15}, {"q16.inp"}}},
+};
+
+
+#ifdef AOC_BENCH
+namespace
+{
+	// consumes the whole transmission 5 bits at a time, like a literal group
+	const auto bench_consume = RegisterKernelBenchmark("BitReader::consume", "q16.inp", [](std::istream& is)
+	{
+		auto transmission = std::string{};
+		std::getline(is, transmission);
+		return [transmission]()
+		{
+			auto stream = std::ispanstream{std::span{transmission}};
+			auto bit_reader = BitReader(stream);
+			auto num_consumed = 0;
+			while (bit_reader.get_bits_consumed() + 5 <= 4*std::ssize(transmission))
+			{
+				do_not_optimize(bit_reader.consume(5));
+				++num_consumed;
+			}
+			return num_consumed;
+		};
+	});
+}
+#endif
@@ -1,5 +1,6 @@
 #include <cmath>
 #include <istream>
+#include "registry.h"
 #include "util.h"
 
 
@@ -13,23 +14,16 @@ namespace
 		int max;
 	};
 
-	std::istream& operator>>(std::istream& is, Range& range)
-	{
-		is >> range.min >> Assert("..") >> range.max;
-		return is;
-	}
-
-
 	struct Area
 	{
 		Range x;
 		Range y;
 	};
 
-	std::istream& operator>>(std::istream& is, Area& area)
+	Scanner& operator>>(Scanner& scanner, Area& area)
 	{
-		is >> Assert("target area: x=") >> area.x >> Assert(", y=") >> area.y;
-		return is;
+		scan<"target area: x={}..{}, y={}..{}">(scanner, area.x.min, area.x.max, area.y.min, area.y.max);
+		return scanner;
 	}
 
 
@@ -65,8 +59,11 @@ namespace
 
 int q17a(std::istream& is)
 {
+	const auto input = InputBuffer(is);
+	auto scanner = Scanner(input.view());
 	auto target = Area{};
-	is >> target;
+	scanner >> target;
+	mark_parsed();
 	auto max_y = 0;
 	for (auto vx = min_speed_for_distance(target.x.min); vx <= target.x.max; ++vx)
 		for (auto vy = target.y.min; vy <= -target.y.min; ++vy)
@@ -85,8 +82,11 @@ int q17a(std::istream& is)
 
 int q17b(std::istream& is)
 {
+	const auto input = InputBuffer(is);
+	auto scanner = Scanner(input.view());
 	auto target = Area{};
-	is >> target;
+	scanner >> target;
+	mark_parsed();
 	auto count = 0;
 	for (auto vx = min_speed_for_distance(target.x.min); vx <= target.x.max; ++vx)
 		for (auto vy = target.y.min; vy <= -target.y.min; ++vy)
@@ -104,3 +104,9 @@ int q17b(std::istream& is)
 			}
 	return count;
 }
+
+
+const auto registration = RegisterSolvers{
+	{"17a", q17a, {{"q17.tst", 45}, {"q17.inp"}}},
+	{"17b", q17b, {{"q17.tst", 112}, {"q17.inp"}}},
+};
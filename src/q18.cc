@@ -3,7 +3,11 @@
 #include <istream>
 #include <optional>
 #include <ranges>
+#include <utility>
 #include <vector>
+#include "kernel_benchmark.h"
+#include "registry.h"
+#include "trace.h"
 #include "util.h"
 
 
@@ -58,6 +62,7 @@ namespace
 
 		void explode()
 		{
+			TRACE_ZONE("q18 explode");
 			int carry_right = 0;
 			for (auto i = 1; i < SIZE; ++i)
 				if (numbers[i] != -1)
@@ -80,6 +85,7 @@ namespace
 
 		bool split()
 		{
+			TRACE_ZONE("q18 split");
 			for (auto i = 0; i < std::ssize(numbers); i += 2)
 				if (numbers[i] > 9)
 				{
@@ -151,6 +157,20 @@ namespace
 	}
 
 
+	auto read_snail_numbers(std::istream& is)
+	{
+		auto numbers = std::vector<SnailNumber<4>>{};
+		for (auto& sn: std::ranges::istream_view<SnailNumber<4>>(is))
+		{
+			numbers.push_back(std::move(sn));
+			is >> Assert('\n');
+			if (is.peek() == '\n')
+				break;
+		}
+		return numbers;
+	}
+
+
 }
 
 
@@ -173,18 +193,38 @@ int q18a(std::istream& is)
 
 int q18b(std::istream& is)
 {
-	auto numbers = std::vector<SnailNumber<4>>{};
-	for (auto& sn: std::ranges::istream_view<SnailNumber<4>>(is))
-	{
-		numbers.push_back(std::move(sn));
-		is >> Assert('\n');
-		if (is.peek() == '\n')
-			break;
-	}
+	const auto numbers = read_snail_numbers(is);
+	mark_parsed();
 	auto max = 0;
 	for (auto i1 = 0; i1 < std::ssize(numbers); ++i1)
+	{
+		poll_cancellation(static_cast<double>(i1) / std::ssize(numbers));
 		for (auto i2 = 0; i2 < std::ssize(numbers); ++i2)
 			if (i1 != i2)
 				max = std::max(max, (numbers[i1]+numbers[i2]).magnitude());
+	}
 	return max;
 }
+
+
+const auto registration = RegisterSolvers{
+	{"18a", q18a, {{"q18.tst", 4140}, {"q18.inp"}}},
+	{"18b", q18b, {{"q18.tst", 3993}, {"q18.inp"}}, Cost::SLOW, std::chrono::seconds{1}},
+};
+
+
+#ifdef AOC_BENCH
+namespace
+{
+	const auto bench_addition = RegisterKernelBenchmark("SnailNumber::operator+", "q18.inp", [](std::istream& is)
+	{
+		return [numbers = read_snail_numbers(is), i = 0u]() mutable
+		{
+			const auto& lhs = numbers[i++ % numbers.size()];
+			const auto& rhs = numbers[i % numbers.size()];
+			do_not_optimize(lhs + rhs);
+			return 1;
+		};
+	});
+}
+#endif
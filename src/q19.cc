@@ -1,8 +1,13 @@
 #include <algorithm>
 #include <istream>
 #include <map>
+#include <memory_resource>
 #include <ranges>
+#include <span>
 #include <vector>
+#include "kernel_benchmark.h"
+#include "registry.h"
+#include "trace.h"
 #include "util.h"
 
 
@@ -32,10 +37,10 @@ namespace {
 	Pos operator+(const Pos& lhs, const Pos& rhs) { return Pos{lhs.x+rhs.x, lhs.y+rhs.y, lhs.z+rhs.z}; }
 	Pos operator-(const Pos& lhs, const Pos& rhs) { return Pos{lhs.x-rhs.x, lhs.y-rhs.y, lhs.z-rhs.z}; }
 
-	std::istream& operator>>(std::istream& is, Pos& pos)
+	Scanner& operator>>(Scanner& scanner, Pos& pos)
 	{
-		is >> pos.x >> Assert(',') >> pos.y >> Assert(',') >> pos.z;
-		return is;
+		scan<"{},{},{}">(scanner, pos.x, pos.y, pos.z);
+		return scanner;
 	}
 
 
@@ -138,9 +143,11 @@ namespace {
 			std::ranges::for_each(known_area, [&](auto& k) { k = Box{rot.rotate(k.min), rot.rotate(k.max)}; });
 		}
 
-		std::optional<std::pair<Pos, Rotation>> match(const Beacons& other) const
+		// translations is only scratch space, kept by the caller so its
+		// memory is reused between matches
+		std::optional<std::pair<Pos, Rotation>> match(const Beacons& other, std::pmr::vector<Pos>& translations) const
 		{
-			std::vector<Pos> translations;
+			TRACE_ZONE("q19 match");
 			for (const auto& rotation: all_rotations)
 			{
 				translations.resize(0);
@@ -166,6 +173,7 @@ namespace {
 
 		void add(Beacons other)
 		{
+			TRACE_ZONE("q19 add");
 			std::ranges::move(other.known_area, std::back_inserter(known_area));
 			std::ranges::move(other.positions, std::back_inserter(positions));
 			std::ranges::sort(positions);
@@ -179,78 +187,124 @@ namespace {
 
 	private:
 		std::vector<Box> known_area{{Box{Pos{-1000,-1000,-1000}, Pos{1000,1000,1000}}}};
-		std::vector<Pos> positions;
+		std::pmr::vector<Pos> positions{arena()};
 	};
 
 
-	Beacons read_scanner(std::istream& is)
+	Beacons read_scanner(Scanner& scanner)
 	{
 		auto i = 0;
-		is >> Assert("--- scanner ") >> i >> Assert(" ---\n");
+		scan<"--- scanner {} ---\n">(scanner, i);
 		auto beacons = Beacons{i};
-		while (is.peek() != EOF && is.peek() != '\n')
-			is >> beacons.emplace_back() >> Assert('\n');
-		is >> Assert('\n');
+		while (!scanner.at_end() && scanner.peek() != '\n')
+			scanner >> beacons.emplace_back() >> Assert('\n');
 		return beacons;
 	}
 
 
-}
+	auto read_scanners(std::istream& is)
+	{
+		TRACE_ZONE("q19 parse");
+		const auto input = InputBuffer(is);
+		auto scanner = Scanner(input.view());
+		auto scanners = std::vector<Beacons>{};
+		while (scanner.has_more())
+			scanners.push_back(read_scanner(scanner));
+		return scanners;
+	}
 
 
-int q19a(std::istream& is)
-{
-	auto scanners = std::vector<Beacons>{};
-	while (is.good())
-		scanners.push_back(read_scanner(is));
-	auto map = std::move(scanners.front());
-	scanners.erase(scanners.begin());
-	while (!scanners.empty())
+	struct AlignedScanners
 	{
-		for (auto it = scanners.begin(); it != scanners.end();)
+		Beacons map;
+		std::pmr::vector<Pos> positions;
+	};
+
+	// merges the beacons of all scanners into the coordinates of the first one
+	AlignedScanners align(std::vector<Beacons> scanners)
+	{
+		const auto num_scanners = std::ssize(scanners);
+		auto aligned = AlignedScanners{std::move(scanners.front()), std::pmr::vector<Pos>({Pos{0,0,0}}, arena())};
+		scanners.erase(scanners.begin());
+		auto translations = std::pmr::vector<Pos>{arena()};
+		while (!scanners.empty())
 		{
-			if (const auto match_result = map.match(*it); match_result)
+			for (auto it = scanners.begin(); it != scanners.end();)
 			{
-				it->rotate_all(match_result->second);
-				it->translate(match_result->first);
-				map.add(std::move(*it));
-				it = scanners.erase(it);
+				poll_cancellation(static_cast<double>(num_scanners - std::ssize(scanners) - 1) / (num_scanners - 1));
+				if (const auto match_result = aligned.map.match(*it, translations); match_result)
+				{
+					aligned.positions.push_back(match_result->first);
+					it->rotate_all(match_result->second);
+					it->translate(match_result->first);
+					aligned.map.add(std::move(*it));
+					it = scanners.erase(it);
+				}
+				else
+					++it;
 			}
-			else
-				++it;
 		}
+		return aligned;
+	}
+
+
+	int largest_distance(std::span<const Pos> positions)
+	{
+		auto max = 0;
+		for (auto i1 = 0; i1 < std::ssize(positions); ++i1)
+			for (auto i2 = 0; i2 < std::ssize(positions); ++i2)
+				max = std::max(max, (positions[i1] - positions[i2]).manhattan());
+		return max;
 	}
-	return map.size();
+
+
+}
+
+
+int q19a(std::istream& is)
+{
+	auto scanners = read_scanners(is);
+	mark_parsed();
+	return align(std::move(scanners)).map.size();
 }
 
 
 int q19b(std::istream& is)
 {
-	auto scanners = std::vector<Beacons>{};
-	while (is.good())
-		scanners.push_back(read_scanner(is));
-	auto map = std::move(scanners.front());
-	scanners.erase(scanners.begin());
-	auto positions = std::vector{Pos{0,0,0}};
-	while (!scanners.empty())
+	auto scanners = read_scanners(is);
+	mark_parsed();
+	return largest_distance(align(std::move(scanners)).positions);
+}
+
+
+Answers q19ab(std::istream& is)
+{
+	auto scanners = read_scanners(is);
+	mark_parsed();
+	const auto aligned = align(std::move(scanners));
+	return {std::ssize(aligned.map), largest_distance(aligned.positions)};
+}
+
+
+const auto registration = RegisterSolvers{
+	{"19a", q19a, {{"q19.tst", 79}, {"q19.inp"}}, Cost::SLOW, std::chrono::seconds{5}},
+	{"19b", q19b, {{"q19.tst", 3621}, {"q19.inp"}}, Cost::SLOW, std::chrono::seconds{5}},
+};
+const auto registration_both = RegisterSolveBoth{{"19a", "19b", q19ab}};
+
+
+#ifdef AOC_BENCH
+namespace
+{
+	// matches the first scanner against all others, most of them do not match
+	const auto bench_match = RegisterKernelBenchmark("Beacons::match", "q19.inp", [](std::istream& is)
 	{
-		for (auto it = scanners.begin(); it != scanners.end();)
+		return [scanners = read_scanners(is), translations = std::pmr::vector<Pos>{}, i = 0u]() mutable
 		{
-			if (const auto match_result = map.match(*it); match_result)
-			{
-				positions.push_back(match_result->first);
-				it->rotate_all(match_result->second);
-				it->translate(match_result->first);
-				map.add(std::move(*it));
-				it = scanners.erase(it);
-			}
-			else
-				++it;
-		}
-	}
-	auto max = 0;
-	for (auto i1 = 0; i1 < std::ssize(positions); ++i1)
-		for (auto i2 = 0; i2 < std::ssize(positions); ++i2)
-			max = std::max(max, (positions[i1] - positions[i2]).manhattan());
-	return max;
+			i = i % (scanners.size() - 1) + 1;
+			do_not_optimize(scanners.front().match(scanners[i], translations));
+			return 1;
+		};
+	});
 }
+#endif
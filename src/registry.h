@@ -0,0 +1,132 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <istream>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+
+// Every solver registers its parts with the inputs they are tested on, the
+// answer is only given for the examples:
+//
+//   const auto registration = RegisterSolvers{
+//       {"01a", q01a, {{"q01.tst", 7}, {"q01.inp"}}},
+//       {"01b", q01b, {{"q01.tst", 5}, {"q01.inp"}}},
+//   };
+//
+// The answers for the real inputs are in the answers file.
+
+
+// rough run time on the real input, slow tests are scheduled first
+enum class Cost
+{
+	FAST,
+	SLOW,
+};
+
+
+using Answer = std::variant<std::int64_t, std::string>;
+
+inline std::ostream& operator<<(std::ostream& os, const Answer& answer)
+{
+	std::visit([&](const auto& value) { os << value; }, answer);
+	return os;
+}
+
+
+struct TestCase
+{
+	std::string input;
+	std::optional<Answer> expected;
+};
+
+
+struct Solver
+{
+	using Function = std::variant<
+		int (*)(std::istream&),
+		std::int64_t (*)(std::istream&),
+		std::string (*)(std::istream&)>;
+
+	std::string name;
+	Function function;
+	std::vector<TestCase> tests;
+	Cost cost = Cost::FAST;
+	// time per run before it is cancelled, zero for the default of the runner
+	std::chrono::milliseconds budget{0};
+};
+
+
+// ordered by name, the order of registration depends on the linker
+inline std::map<std::string, Solver, std::less<>>& registered_solvers()
+{
+	static auto solvers = std::map<std::string, Solver, std::less<>>{};
+	return solvers;
+}
+
+
+struct RegisterSolvers
+{
+	RegisterSolvers(std::initializer_list<Solver> solvers)
+	{
+		for (const auto& solver: solvers)
+			if (!registered_solvers().emplace(solver.name, solver).second)
+				throw std::logic_error("Solver " + solver.name + " is registered twice");
+	}
+};
+
+
+// Puzzles where both parts share most of the work can also solve them
+// together, from a single parse. The test runner prefers that when both
+// parts are run on the same input:
+//
+//   const auto registration_both = RegisterSolveBoth{{"19a", "19b", q19ab}};
+struct Answers
+{
+	Answer a;
+	Answer b;
+};
+
+
+struct SolveBoth
+{
+	std::string part_a;
+	std::string part_b;
+	Answers (*function)(std::istream&);
+};
+
+
+// by the name of part a
+inline std::map<std::string, SolveBoth, std::less<>>& registered_solve_both()
+{
+	static auto solvers = std::map<std::string, SolveBoth, std::less<>>{};
+	return solvers;
+}
+
+
+struct RegisterSolveBoth
+{
+	RegisterSolveBoth(SolveBoth solver)
+	{
+		if (!registered_solve_both().emplace(solver.part_a, solver).second)
+			throw std::logic_error("Solver " + solver.part_a + " is registered twice");
+	}
+};
+
+
+// * matches any number of characters, ? a single one
+constexpr bool glob_match(std::string_view pattern, std::string_view name)
+{
+	if (pattern.empty())
+		return name.empty();
+	if (pattern.front() == '*')
+		return glob_match(pattern.substr(1), name) || (!name.empty() && glob_match(pattern, name.substr(1)));
+	return !name.empty() && (pattern.front() == '?' || pattern.front() == name.front()) && glob_match(pattern.substr(1), name.substr(1));
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+
+// Scoped tracing zones, written as a Chrome trace (open it in Perfetto or
+// chrome://tracing):
+//
+//   TRACE_ZONE("q15 solve");
+//
+// records the time from there to the end of the scope. Every thread records
+// into its own ring buffer, which keeps the latest events when it is full.
+// When tracing is not enabled a zone only checks a flag; defining
+// AOC_NO_TRACE removes the zones altogether.
+class Tracer
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Event
+	{
+		std::string_view name;
+		Clock::time_point start;
+		Clock::time_point end;
+	};
+
+	static Tracer& instance()
+	{
+		static auto tracer = Tracer{};
+		return tracer;
+	}
+
+	bool enabled() const { return is_enabled.load(std::memory_order_relaxed); }
+
+	void enable()
+	{
+		start_time = Clock::now();
+		is_enabled = true;
+	}
+
+	void record(const Event& event)
+	{
+		auto& buffer = buffer_of_this_thread();
+		if (buffer.events.size() < capacity)
+			buffer.events.push_back(event);
+		else
+			buffer.events[buffer.next % capacity] = event;
+		++buffer.next;
+	}
+
+	// only when no thread is recording any more
+	void write_chrome_json(std::ostream& os) const
+	{
+		auto lock = std::scoped_lock{mutex};
+		auto us = [&](Clock::time_point time) { return std::chrono::duration<double, std::micro>{time - start_time}.count(); };
+		os << "{\"traceEvents\": [\n";
+		auto first = true;
+		for (const auto& buffer: buffers)
+			for (const auto& [name, start, end]: buffer->events)
+			{
+				os << (first ? "" : ",\n") << "  {\"name\": \"";
+				for (const char c: name)
+					os << ((c == '"' || c == '\\') ? "\\" : "") << c;
+				os << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->thread
+				   << ", \"ts\": " << us(start) << ", \"dur\": " << us(end) - us(start) << '}';
+				first = false;
+			}
+		os << "\n]}\n";
+	}
+
+private:
+	static constexpr std::size_t capacity = 1 << 16;
+
+	struct Buffer
+	{
+		int thread;
+		std::vector<Event> events;
+		std::size_t next = 0;
+	};
+
+	Buffer& buffer_of_this_thread()
+	{
+		thread_local auto* buffer = [this]
+		{
+			auto lock = std::scoped_lock{mutex};
+			return buffers.emplace_back(std::make_unique<Buffer>(static_cast<int>(buffers.size()))).get();
+		}();
+		return *buffer;
+	}
+
+	std::atomic<bool> is_enabled = false;
+	Clock::time_point start_time;
+	mutable std::mutex mutex;
+	std::vector<std::unique_ptr<Buffer>> buffers;
+};
+
+
+class TraceZone
+{
+public:
+	explicit TraceZone(std::string_view zone_name)
+	{
+		if (Tracer::instance().enabled())
+		{
+			name = zone_name;
+			start = Tracer::Clock::now();
+		}
+	}
+
+	~TraceZone()
+	{
+		if (!name.empty())
+			Tracer::instance().record({name, start, Tracer::Clock::now()});
+	}
+
+	TraceZone(const TraceZone&) = delete;
+	TraceZone& operator=(const TraceZone&) = delete;
+
+private:
+	std::string_view name;
+	Tracer::Clock::time_point start;
+};
+
+
+#ifdef AOC_NO_TRACE
+#define TRACE_ZONE(name)
+#else
+#define TRACE_ZONE_CONCAT2(a, b) a##b
+#define TRACE_ZONE_CONCAT(a, b) TRACE_ZONE_CONCAT2(a, b)
+#define TRACE_ZONE(name) const auto TRACE_ZONE_CONCAT(trace_zone_, __LINE__) = TraceZone{name}
+#endif
@@ -1,9 +1,27 @@
 #pragma once
 #include <algorithm>
+#include <bit>
 #include <charconv>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <optional>
 #include <ranges>
+#include <spanstream>
 #include <sstream>
+#include <stdexcept>
+#include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 
 template<typename Op = std::plus<>>
@@ -19,6 +37,117 @@ auto accumulate(std::ranges::input_range auto&& range, auto init, Op&& op = Op{}
 }
 
 
+// Solvers call mark_parsed() once their input has been read, so the test runner
+// can report parse and compute time separately.
+inline std::chrono::steady_clock::time_point& parse_end_time()
+{
+	thread_local auto time_point = std::chrono::steady_clock::time_point{};
+	return time_point;
+}
+
+inline void mark_parsed() { parse_end_time() = std::chrono::steady_clock::now(); }
+
+
+// Long running solvers call poll_cancellation() regularly with how far they
+// got (0 to 1). Once the time budget the test runner gave them is used up,
+// it throws Cancelled so the runner can report a timeout.
+struct Cancelled : std::runtime_error
+{
+	explicit Cancelled(double p) : std::runtime_error("Cancelled"), progress(p) {}
+	double progress;
+};
+
+inline std::chrono::steady_clock::time_point& cancellation_deadline()
+{
+	thread_local auto time_point = std::chrono::steady_clock::time_point::max();
+	return time_point;
+}
+
+inline void poll_cancellation(double progress)
+{
+	if (std::chrono::steady_clock::now() > cancellation_deadline())
+		throw Cancelled(progress);
+}
+
+
+// Solvers allocate their temporary containers from a per-thread arena:
+//
+//   auto basins = std::pmr::vector<int>{arena()};
+//
+// It is only an arena while an ArenaScope is alive, which the test runner
+// opens around every run; all its memory is released at once at the end of
+// the scope. Nothing is freed before that, so containers that are refilled
+// in a loop are better reused than recreated. Outside of a scope, like in the
+// kernel benchmarks, arena() is the default memory resource.
+class Arena
+{
+public:
+	static Arena& for_this_thread()
+	{
+		thread_local auto arena = Arena{};
+		return arena;
+	}
+
+	std::pmr::memory_resource* resource() { return monotonic ? &*monotonic : std::pmr::get_default_resource(); }
+
+	void begin()
+	{
+		if (!buffer)
+			buffer = std::make_unique_for_overwrite<std::byte[]>(buffer_size);
+		monotonic.emplace(buffer.get(), buffer_size, &overflow);
+	}
+
+	// the buffer grows by what did not fit in it, so the next run does not
+	// need the heap
+	void end()
+	{
+		monotonic.reset();
+		if (overflow.bytes > 0)
+		{
+			buffer_size += overflow.bytes;
+			buffer = std::make_unique_for_overwrite<std::byte[]>(buffer_size);
+			overflow.bytes = 0;
+		}
+	}
+
+private:
+	struct Overflow : std::pmr::memory_resource
+	{
+		std::size_t bytes = 0;
+
+		void* do_allocate(std::size_t size, std::size_t alignment) override
+		{
+			bytes += size;
+			return std::pmr::new_delete_resource()->allocate(size, alignment);
+		}
+
+		void do_deallocate(void* p, std::size_t size, std::size_t alignment) override
+		{
+			std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+	};
+
+	std::size_t buffer_size = 1 << 20;
+	std::unique_ptr<std::byte[]> buffer;
+	Overflow overflow;
+	std::optional<std::pmr::monotonic_buffer_resource> monotonic;
+};
+
+inline std::pmr::memory_resource* arena() { return Arena::for_this_thread().resource(); }
+
+class ArenaScope
+{
+public:
+	explicit ArenaScope() { Arena::for_this_thread().begin(); }
+	~ArenaScope() { Arena::for_this_thread().end(); }
+
+	ArenaScope(const ArenaScope&) = delete;
+	ArenaScope& operator=(const ArenaScope&) = delete;
+};
+
+
 template<typename T>
 T read(std::istream& is) { auto result = T{}; is >> result; return result; }
 
@@ -123,3 +252,367 @@ Container read_non_separated(std::istream& is)
 	std::ranges::move(view, std::back_inserter(result));
 	return result;
 }
+
+
+// The remaining input of a stream as one contiguous buffer. Streams that are
+// backed by memory already (like the test runner's --preload mode) are not
+// copied, anything else is read into the buffer.
+class InputBuffer
+{
+public:
+	explicit InputBuffer(std::istream& is)
+	{
+		if (auto* const span_stream = dynamic_cast<std::ispanstream*>(&is))
+		{
+			const auto span = span_stream->span();
+			const auto offset = std::streamoff{is.tellg()};
+			const auto position = (offset < 0) ? span.size() : std::min(static_cast<std::size_t>(offset), span.size());
+			contents = std::string_view{span.data() + position, span.size() - position};
+			is.seekg(0, std::ios::end);
+		}
+		else
+		{
+			storage.assign(std::istreambuf_iterator<char>{is}, std::istreambuf_iterator<char>{});
+			contents = storage;
+		}
+		is.setstate(std::ios::eofbit);
+	}
+
+	InputBuffer(const InputBuffer&) = delete;
+	InputBuffer& operator=(const InputBuffer&) = delete;
+
+	std::string_view view() const { return contents; }
+
+private:
+	std::string storage;
+	std::string_view contents;
+};
+
+
+// Calls func for every whitespace separated number, which has a '-' in
+// front when it is negative, like for Scanner::number. The stream is read a
+// block at a time, so the input does not have to fit in memory.
+template<std::integral T>
+void for_each_streamed(std::istream& is, auto&& func)
+{
+	// the digits are added up without the sign, a negative number can be one
+	// further from zero than a positive one
+	using Magnitude = std::make_unsigned_t<T>;
+	constexpr auto max_positive = static_cast<Magnitude>(std::numeric_limits<T>::max());
+	char block[1 << 16];
+	auto magnitude = Magnitude{0};
+	auto negative = false;
+	auto in_number = false;
+	auto has_digits = false;
+	auto finish_number = [&]
+	{
+		if (!has_digits)
+			throw std::runtime_error("Expected a number, found \"-\"");
+		func(negative ? static_cast<T>(Magnitude{0} - magnitude) : static_cast<T>(magnitude));
+		magnitude = 0;
+		negative = false;
+		in_number = false;
+		has_digits = false;
+	};
+	while (is)
+	{
+		is.read(block, sizeof(block));
+		for (const char c: std::string_view{block, static_cast<std::size_t>(is.gcount())})
+		{
+			if (const auto digit = static_cast<unsigned>(c - '0'); digit <= 9)
+			{
+				const auto limit = negative ? static_cast<Magnitude>(max_positive + 1) : max_positive;
+				if (magnitude > (limit - digit) / 10)
+					throw std::runtime_error("Number does not fit in " + std::to_string(sizeof(T)) + " bytes");
+				magnitude = static_cast<Magnitude>(magnitude * 10 + digit);
+				in_number = true;
+				has_digits = true;
+			}
+			else if (c == ' ' || c == '\n' || c == '\t' || c == '\r')
+			{
+				if (in_number)
+					finish_number();
+			}
+			else if (c == '-' && std::is_signed_v<T> && !in_number)
+			{
+				negative = true;
+				in_number = true;
+			}
+			else
+				throw std::runtime_error("Expected a number, found \"" + std::string{c} + "\"");
+		}
+	}
+	if (in_number)
+		finish_number();
+}
+
+
+// Cursor over a character buffer, the counterpart of formatted extraction
+// from a std::istream without locales or per-token stream state.
+class Scanner
+{
+public:
+	explicit Scanner(std::string_view input) : rest(input) {}
+
+	bool at_end() const { return rest.empty(); }
+	char peek() const { return rest.empty() ? '\0' : rest.front(); }
+	char get() { const auto c = peek(); rest.remove_prefix(!rest.empty()); return c; }
+	std::string_view remaining() const { return rest; }
+	void skip(std::size_t size) { rest.remove_prefix(std::min(size, rest.size())); }
+
+	void skip_whitespace()
+	{
+		while (!rest.empty() && is_whitespace(rest.front()))
+			rest.remove_prefix(1);
+	}
+
+	// skips whitespace, returns whether anything is left after it
+	bool has_more()
+	{
+		skip_whitespace();
+		return !at_end();
+	}
+
+	// skips leading whitespace
+	std::string_view word()
+	{
+		skip_whitespace();
+		const auto end = std::ranges::find_if(rest, is_whitespace);
+		return take(end - rest.begin());
+	}
+
+	// the rest of the current line, the newline is consumed but not returned
+	std::string_view line()
+	{
+		const auto end = rest.find('\n');
+		const auto result = take(std::min(end, rest.size()));
+		rest.remove_prefix(!rest.empty());
+		return result;
+	}
+
+	// skips leading whitespace
+	template<typename T>
+	T number()
+	{
+		skip_whitespace();
+		auto value = T{};
+		const auto [end, error] = std::from_chars(rest.data(), rest.data() + rest.size(), value);
+		if (error != std::errc{})
+			throw std::runtime_error("Expected a number, found \"" + std::string{rest.substr(0, 10)} + "\"");
+		rest.remove_prefix(end - rest.data());
+		return value;
+	}
+
+	// does not skip whitespace
+	void expect(std::string_view literal)
+	{
+		if (!rest.starts_with(literal))
+			throw std::runtime_error("Expected \"" + std::string{literal} + "\", found \"" + std::string{rest.substr(0, literal.size())} + "\"");
+		rest.remove_prefix(literal.size());
+	}
+
+	void expect(char c) { expect(std::string_view{&c, 1}); }
+
+private:
+	static bool is_whitespace(char c) { return c == ' ' || c == '\n' || c == '\t' || c == '\r'; }
+
+	std::string_view take(std::size_t size)
+	{
+		const auto result = rest.substr(0, size);
+		rest.remove_prefix(size);
+		return result;
+	}
+
+	std::string_view rest;
+};
+
+
+// Extraction from a Scanner, with the same semantics as from a std::istream:
+// numbers and chars skip leading whitespace, asserted literals do not.
+template<typename T>
+	requires std::integral<T> && (!std::same_as<T, char>)
+Scanner& operator>>(Scanner& scanner, T& value)
+{
+	value = scanner.number<T>();
+	return scanner;
+}
+
+inline Scanner& operator>>(Scanner& scanner, char& c)
+{
+	scanner.skip_whitespace();
+	c = scanner.get();
+	return scanner;
+}
+
+inline Scanner& operator>>(Scanner& scanner, const Assert<char>& a)
+{
+	scanner.expect(a.expected);
+	return scanner;
+}
+
+inline Scanner& operator>>(Scanner& scanner, const Assert<const char*>& a)
+{
+	scanner.expect(std::string_view{a.expected});
+	return scanner;
+}
+
+
+// Pattern for scan(), where every "{}" is a value to read. The literal parts
+// are split off at compile time.
+template<std::size_t N>
+struct Pattern
+{
+	constexpr Pattern(const char (&s)[N]) { std::copy_n(s, N, text); }
+
+	constexpr std::string_view view() const { return {text, N-1}; }
+
+	constexpr std::size_t placeholders() const
+	{
+		auto count = std::size_t{0};
+		for (auto pos = view().find("{}"); pos != std::string_view::npos; pos = view().find("{}", pos+2))
+			++count;
+		return count;
+	}
+
+	// the literal in front of placeholder index, or after the last one
+	constexpr std::string_view literal(std::size_t index) const
+	{
+		auto start = std::size_t{0};
+		for (; index > 0; --index)
+			start = view().find("{}", start) + 2;
+		return view().substr(start, view().find("{}", start) - start);
+	}
+
+	char text[N];
+};
+
+template<Pattern pattern, std::size_t index>
+void expect_literal(Scanner& scanner)
+{
+	static constexpr auto literal = pattern.literal(index);
+	if constexpr (!literal.empty())
+		scanner.expect(literal);
+}
+
+// Reads values according to a pattern, e.g. scan<"x={}..{}">(scanner, min, max)
+// is scanner >> Assert("x=") >> min >> Assert("..") >> max
+template<Pattern pattern>
+void scan(Scanner& scanner, auto&... values)
+{
+	static_assert(pattern.placeholders() == sizeof...(values), "Number of values does not match the pattern");
+	[&]<std::size_t... I>(std::index_sequence<I...>)
+	{
+		((expect_literal<pattern, I>(scanner), scanner >> values), ...);
+	}(std::index_sequence_for<decltype(values)...>{});
+	expect_literal<pattern, sizeof...(values)>(scanner);
+}
+
+
+// calls func for every T that is read, until the end of the input
+template<typename T>
+void for_each_read(Scanner& scanner, auto&& func)
+{
+	while (scanner.has_more())
+	{
+		auto value = T{};
+		scanner >> value;
+		func(value);
+	}
+}
+
+
+// Bit i is set when data[i] is a or b, for 32 bytes starting at data. Uses
+// AVX2 or SSE2 when the compiler targets them.
+inline std::uint32_t find_either(const char* data, char a, char b)
+{
+#if defined(__AVX2__)
+	const auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+	const auto matches = _mm256_or_si256(
+		_mm256_cmpeq_epi8(block, _mm256_set1_epi8(a)),
+		_mm256_cmpeq_epi8(block, _mm256_set1_epi8(b)));
+	return static_cast<std::uint32_t>(_mm256_movemask_epi8(matches));
+#elif defined(__SSE2__)
+	auto half = [&](const char* p) -> std::uint32_t
+	{
+		const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		const auto matches = _mm_or_si128(
+			_mm_cmpeq_epi8(block, _mm_set1_epi8(a)),
+			_mm_cmpeq_epi8(block, _mm_set1_epi8(b)));
+		return static_cast<std::uint16_t>(_mm_movemask_epi8(matches));
+	};
+	return half(data) | (half(data + 16) << 16);
+#else
+	auto mask = std::uint32_t{0};
+	for (auto i = 0; i < 32; ++i)
+		mask |= static_cast<std::uint32_t>(data[i] == a || data[i] == b) << i;
+	return mask;
+#endif
+}
+
+
+// Decodes a field that holds nothing but an optionally negative integer.
+template<std::integral T>
+T decode_integer(const char* begin, const char* end)
+{
+	const bool negative = (begin != end && *begin == '-');
+	begin += negative;
+	if (begin == end)
+		throw std::runtime_error("Expected a number");
+	auto value = T{0};
+	for (; begin != end; ++begin)
+	{
+		const auto digit = static_cast<unsigned>(*begin - '0');
+		if (digit > 9)
+			throw std::runtime_error("Expected a number, found \"" + std::string{*begin} + "\"");
+		value = static_cast<T>(value * 10 + digit);
+	}
+	return negative ? static_cast<T>(-value) : value;
+}
+
+
+// Calls func for every number in a separated list that ends at end (which is
+// consumed) or at the end of the input. Separators are located 32 bytes at a
+// time instead of one character per extraction.
+template<std::integral T>
+void for_each_separated(Scanner& scanner, auto&& func, const char separator = ',', const char end = '\n')
+{
+	scanner.skip_whitespace();
+	const auto input = scanner.remaining();
+	const char* const first = input.data();
+	const char* const last = first + input.size();
+	const char* field = first;
+	// returns whether the list ended
+	auto field_ends_at = [&](const char* delimiter)
+	{
+		func(decode_integer<T>(field, delimiter));
+		field = delimiter + 1;
+		if (*delimiter != end)
+			return false;
+		scanner.skip(field - first);
+		return true;
+	};
+	const char* block = first;
+	for (; last - block >= 32; block += 32)
+		for (auto mask = find_either(block, separator, end); mask != 0; mask &= mask - 1)
+			if (field_ends_at(block + std::countr_zero(mask)))
+				return;
+	for (; block != last; ++block)
+		if ((*block == separator || *block == end) && field_ends_at(block))
+			return;
+	if (field != last)
+		func(decode_integer<T>(field, last));
+	scanner.skip(input.size());
+}
+
+
+template<typename Container>
+auto read_separated(Scanner& scanner, const char separator = ',', const char end = '\n')
+{
+	Container result;
+	for_each_separated<typename Container::value_type>(
+		scanner,
+		[&](auto value) { result.push_back(value); },
+		separator,
+		end);
+	return result;
+}
@@ -1,13 +1,40 @@
 #pragma once
+#include <algorithm>
+#include <charconv>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <iomanip>
 #include <iostream>
+#include <latch>
 #include <map>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <semaphore>
 #include <set>
+#include <spanstream>
+#include <sstream>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <variant>
+#include <vector>
+#include "allocation_counter.h"
+#include "benchmark.h"
+#include "mapped_file.h"
+#include "perf_counters.h"
+#include "report.h"
+#include "result_cache.h"
+#include "server.h"
+#include "thread_pool.h"
+#include "src/registry.h"
+#include "src/trace.h"
+#include "src/util.h"
 
 
 class TestRunner
@@ -25,11 +52,104 @@ public:
 				answers.emplace(name, answer);
 		}
 		for (int i = 1; i < argc; ++i)
-			tests_to_run.insert(argv[i]);
+		{
+			const auto arg = std::string_view{argv[i]};
+			auto value = [&]
+			{
+				if (++i == argc)
+					throw std::runtime_error("Missing value for " + std::string{arg});
+				return std::string{argv[i]};
+			};
+			if (arg == "--bench")
+				bench = true;
+			else if (arg == "--preload")
+				preload = true;
+			else if (arg == "--perf")
+				perf = true;
+			else if (arg == "--parallel")
+				parallel = true;
+			else if (arg == "--jobs")
+				num_threads = std::stoi(value());
+			else if (arg == "--csv")
+				csv_path = value();
+			else if (arg == "--json")
+				json_path = value();
+			else if (arg == "--baseline")
+				baseline_path = value();
+			else if (arg == "--cache")
+				cache_path = value();
+			else if (arg == "--no-cache")
+				use_cache = false;
+			else if (arg == "--batch")
+			{
+				// also accepts the name of the function, like q15a
+				batch_test = value();
+				if (batch_test.starts_with('q'))
+					batch_test.erase(0, 1);
+				batch_dir = value();
+			}
+			else if (arg == "--trace")
+				trace_path = value();
+			else if (arg == "--serve")
+				serve_path = value();
+			else if (arg == "--sweep")
+				sweep_dir = value();
+			else if (arg == "--max-regression")
+				regression_threshold.relative = std::stod(value()) / 100;
+			else if (arg == "--min-regression-us")
+				regression_threshold.absolute = Statistics::Duration{std::stod(value())};
+			else if (arg == "--budget")
+				budget_override = std::chrono::milliseconds{std::stoi(value())};
+			else if (arg == "--warmup")
+				bench_settings.warmup = std::stoi(value());
+			else if (arg == "--bench-time")
+				bench_settings.target_time = std::chrono::milliseconds{std::stoi(value())};
+			else if (arg.starts_with("--"))
+				throw std::runtime_error("Unknown option " + std::string{arg});
+			else
+				tests_to_run.insert(argv[i]);
+		}
+		if (!trace_path.empty())
+			Tracer::instance().enable();
+		// cached timings would be meaningless for benchmarks, performance counters and traces
+		if (use_cache && !bench && !perf && trace_path.empty())
+		{
+			const auto executable = std::filesystem::exists("/proc/self/exe") ? std::filesystem::path{"/proc/self/exe"} : std::filesystem::path{argv[0]};
+			cache.emplace(cache_path, executable);
+		}
+	}
+
+	// adds a test for every input of a registered solver
+	void operator()(const Solver& solver)
+	{
+		if (!batch_test.empty())
+			return add_batch_job(solver);
+		if (solver.cost == Cost::SLOW)
+			slow_tests.insert(solver.name);
+		if (solver.budget > std::chrono::milliseconds::zero())
+			budgets.emplace(solver.name, solver.budget);
+		add_solve_both(solver);
+		std::visit([&](auto func)
+		{
+			using ReturnType = decltype(func(std::cin));
+			for (const auto& [input, expected]: solver.tests)
+				if (solved_together.contains(std::make_pair(solver.name, input)))
+					continue;
+				else if (!expected)
+					(*this)(func, solver.name, input);
+				else if constexpr (std::is_integral_v<ReturnType>)
+					(*this)(func, solver.name, input, std::get<std::int64_t>(*expected));
+				else
+					(*this)(func, solver.name, input, std::get<std::string>(*expected));
+		}, solver.function);
 	}
 
-	void operator()(auto&& func, std::string_view name, const std::filesystem::path& path) const
+	void operator()(auto&& func, std::string_view name, const std::filesystem::path& path)
 	{
+		if (!serve_path.empty())
+			return add_solver(func, name);
+		if (!sweep_dir.empty())
+			return add_sweep_jobs(func, name, path);
 		const auto it = answers.find(name);
 		if (it != answers.end())
 		{
@@ -41,35 +161,527 @@ public:
 		}
 		else
 		{
-			if (!tests_to_run.empty() && !tests_to_run.contains(name))
+			if (!selected(name))
 				return;
-			const auto result = run(func, name, path);
-			std::cout << "Test " << name << " produced " << result << std::endl;
+			add_job(name, path, [=, this, name = std::string{name}](std::ostream& out, std::ostream&, Statistics& statistics)
+			{
+				const auto result = run(func, name, path, out, statistics);
+				out << "Test " << name << " produced " << result << std::endl;
+			});
 		}
 	}
 
-	void operator()(auto&& func, std::string_view name, const std::filesystem::path& path, const auto& expected_output) const
+	void operator()(auto&& func, std::string_view name, const std::filesystem::path& path, const auto& expected_output)
 	{
-		if (!tests_to_run.empty() && !tests_to_run.contains(name))
+		if (!serve_path.empty())
+			return add_solver(func, name);
+		if (!sweep_dir.empty())
+			return add_sweep_jobs(func, name, path);
+		if (!selected(name))
 			return;
-		const auto result = run(func, name, path);
-		if (result != expected_output)
-				std::cerr << "Test " << name << " failed with input (" << path << "), expected: " << expected_output << ", got: " << result << std::endl;
+		add_job(name, path, [=, this, name = std::string{name}](std::ostream& out, std::ostream& err, Statistics& statistics)
+		{
+			const auto result = run(func, name, path, out, statistics);
+			if (result != expected_output)
+					err << "Test " << name << " failed with input (" << path << "), expected: " << expected_output << ", got: " << result << std::endl;
+		});
+	}
+
+	// runs all tests that were added, either one by one in the order they were
+	// added, or in parallel with their output still printed in that order;
+	// returns non-zero when a test timed out or regressed compared to the
+	// baseline
+	int execute()
+	{
+		if (!serve_path.empty())
+		{
+			SolverServer(std::move(solvers), num_threads, cache ? &*cache : nullptr).serve(serve_path);
+			return 0;
+		}
+		if (!batch_test.empty() && jobs.empty())
+		{
+			std::cerr << "No test " << batch_test << " to run with --batch" << std::endl;
+			return 1;
+		}
+		if (parallel)
+			execute_parallel();
+		else
+			for (auto& job: jobs)
+				job.run(std::cout, std::cerr, job.statistics);
+		auto records = std::vector<TimingRecord>{};
+		for (const auto& job: jobs)
+			records.push_back(TimingRecord{job.name, job.path.string(), job.statistics});
+		if (!trace_path.empty())
+		{
+			// the names of the tests are owned by the jobs
+			auto os = std::ofstream(trace_path);
+			Tracer::instance().write_chrome_json(os);
+		}
+		jobs.clear();
+		if (cache)
+			cache->save();
+		if (!csv_path.empty())
+		{
+			auto os = std::ofstream(csv_path);
+			write_csv(os, records);
+		}
+		if (!json_path.empty())
+		{
+			auto os = std::ofstream(json_path);
+			write_json(os, records);
+		}
+		if (!baseline_path.empty() && report_regressions(std::cerr, read_csv(baseline_path), records, regression_threshold) > 0)
+			return 1;
+		return std::ranges::any_of(records, [](const auto& record) { return record.statistics.timed_out; }) ? 1 : 0;
 	}
 
 private:
-	static auto run(auto&& func, std::string_view name, const std::filesystem::path& path)
+	struct Input
+	{
+		MappedFile file;
+		std::chrono::nanoseconds io_time;
+		std::uint64_t hash;
+	};
+
+	struct Job
+	{
+		std::string name;
+		std::filesystem::path path;
+		std::function<void(std::ostream& out, std::ostream& err, Statistics& statistics)> run;
+		Statistics statistics;
+	};
+
+	struct Phases
+	{
+		std::chrono::nanoseconds parse;
+		std::chrono::nanoseconds compute;
+	};
+
+	// with --batch, the only test is the selected solver on all files in a directory
+	void add_batch_job(const Solver& solver)
+	{
+		if (solver.name != batch_test)
+			return;
+		std::visit([&](auto func)
+		{
+			add_job(solver.name, batch_dir, [=, this, name = solver.name](std::ostream& out, std::ostream&, Statistics& statistics)
+			{
+				statistics = run_batch(func, name, out);
+			});
+		}, solver.function);
+	}
+
+	// Runs a solver on every file in the batch directory on the thread pool.
+	// A loader thread reads the files ahead of the workers, at most two per
+	// worker, so reading overlaps solving. Returns the statistics of the
+	// latencies of the solver.
+	Statistics run_batch(auto func, std::string_view name, std::ostream& out) const
 	{
-		std::ifstream is("input" / path);
-		if (!is.good())
-			throw std::runtime_error("Could not find " + path.string());
+		auto paths = std::vector<std::filesystem::path>{};
+		for (const auto& entry: std::filesystem::directory_iterator(batch_dir))
+			if (entry.is_regular_file())
+				paths.push_back(entry.path());
+		std::ranges::sort(paths);
+		struct Result
+		{
+			std::string answer;
+			std::chrono::nanoseconds latency;
+			std::size_t bytes;
+			bool loaded;
+		};
+		auto results = std::vector<Result>(paths.size());
 		const auto start = std::chrono::steady_clock::now();
-		const auto result = func(is);
-		const auto end = std::chrono::steady_clock::now();
+		{
+			auto pool = ThreadPool{num_threads};
+			auto in_flight = std::counting_semaphore<>(2 * pool.size());
+			auto done = std::latch(std::ssize(paths));
+			auto loader = std::jthread([&]
+			{
+				for (auto i = 0u; i < paths.size(); ++i)
+				{
+					in_flight.acquire();
+					auto input = std::optional<MappedFile>{};
+					try
+					{
+						input.emplace(paths[i]);
+					}
+					catch (const std::exception& e)
+					{
+						// a file that cannot be read is reported like a solver error
+						results[i] = Result{std::string{"error: "} + e.what(), {}, 0, false};
+						in_flight.release();
+						done.count_down();
+						continue;
+					}
+					pool.submit([&, i, input = std::move(*input)]
+					{
+						auto is = std::ispanstream{std::span<const char>{input.view()}};
+						auto answer = std::ostringstream{};
+						const auto solve_start = std::chrono::steady_clock::now();
+						try
+						{
+							const auto arena_scope = ArenaScope{};
+							answer << func(is);
+						}
+						catch (const std::exception& e)
+						{
+							answer << "error: " << e.what();
+						}
+						results[i] = Result{answer.str(), std::chrono::steady_clock::now() - solve_start, input.view().size(), true};
+						in_flight.release();
+						done.count_down();
+					});
+				}
+			});
+			done.wait();
+		}
+		const auto elapsed = std::chrono::duration<double>{std::chrono::steady_clock::now() - start};
+		auto latencies = std::vector<std::chrono::nanoseconds>{};
+		auto bytes = 0.0;
+		for (auto i = 0u; i < paths.size(); ++i)
+		{
+			out << "Test " << name << " produced " << results[i].answer << " with input " << paths[i] << '\n';
+			if (results[i].loaded)
+				latencies.push_back(results[i].latency);
+			bytes += results[i].bytes;
+		}
+		const auto statistics = Statistics::from(std::move(latencies));
+		const auto flags = out.flags();
+		out << std::fixed << std::setprecision(1)
+		    << "Batch " << name << ": " << paths.size() << " inputs, " << bytes/1e6 << " MB in " << elapsed.count()*1000 << " ms, "
+		    << paths.size()/elapsed.count() << " inputs/s, " << bytes/1e6/elapsed.count() << " MB/s, latency " << statistics << std::endl;
+		out.flags(flags);
+		return statistics;
+	}
+
+	// Runs both parts of a puzzle together on the inputs they have in common,
+	// if the puzzle supports that and both parts are selected. Called for
+	// part a, part b then skips those inputs.
+	void add_solve_both(const Solver& part_a)
+	{
+		const auto both = registered_solve_both().find(part_a.name);
+		if (both == registered_solve_both().end() || !serve_path.empty() || !sweep_dir.empty())
+			return;
+		const auto part_b = registered_solvers().find(both->second.part_b);
+		if (part_b == registered_solvers().end() || !selected(part_a.name) || !selected(part_b->first))
+			return;
+		const auto name = part_a.name + '+' + part_b->first;
+		if (part_a.cost == Cost::SLOW || part_b->second.cost == Cost::SLOW)
+			slow_tests.insert(name);
+		if (part_a.budget > std::chrono::milliseconds::zero() && part_b->second.budget > std::chrono::milliseconds::zero())
+			budgets.emplace(name, std::max(part_a.budget, part_b->second.budget));
+		for (const auto& test_a: part_a.tests)
+		{
+			const auto test_b = std::ranges::find(part_b->second.tests, test_a.input, &TestCase::input);
+			if (test_b == part_b->second.tests.end())
+				continue;
+			solved_together.emplace(part_a.name, test_a.input);
+			solved_together.emplace(part_b->first, test_a.input);
+			const auto path = std::filesystem::path{test_a.input};
+			const auto expected_a = expected_answer(part_a.name, test_a);
+			const auto expected_b = expected_answer(part_b->first, *test_b);
+			add_job(name, path, [=, this, func = both->second.function, name_a = part_a.name, name_b = part_b->first](std::ostream& out, std::ostream& err, Statistics& statistics)
+			{
+				const auto answers = run(func, name, path, out, statistics);
+				report_answer(out, err, name_a, path, answers.a, expected_a);
+				report_answer(out, err, name_b, path, answers.b, expected_b);
+			});
+		}
+	}
+
+	// the answer of an example, or else the one in the answers file
+	std::optional<std::string> expected_answer(std::string_view name, const TestCase& test) const
+	{
+		if (test.expected)
+		{
+			auto answer = std::ostringstream{};
+			answer << *test.expected;
+			return answer.str();
+		}
+		if (const auto it = answers.find(name); it != answers.end())
+			return it->second;
+		return std::nullopt;
+	}
+
+	static void report_answer(std::ostream& out, std::ostream& err, std::string_view name, const std::filesystem::path& path, const Answer& result, const std::optional<std::string>& expected)
+	{
+		auto answer = std::ostringstream{};
+		answer << result;
+		if (!expected)
+			out << "Test " << name << " produced " << answer.str() << std::endl;
+		else if (answer.str() != *expected)
+			err << "Test " << name << " failed with input (" << path << "), expected: " << *expected << ", got: " << answer.str() << std::endl;
+	}
+
+	// the names on the command line may contain wildcards, like 15* or *b
+	bool selected(std::string_view name) const
+	{
+		return tests_to_run.empty() || std::ranges::any_of(tests_to_run, [&](const auto& pattern) { return glob_match(pattern, name); });
+	}
+
+	// With --sweep, the real input of a test is replaced by all inputs that
+	// were generated for the same puzzle (see generator.cc), smallest first.
+	// Tests on the example inputs are skipped.
+	void add_sweep_jobs(auto&& func, std::string_view name, const std::filesystem::path& path)
+	{
+		if (path.extension() != ".inp" || !selected(name))
+			return;
+		auto sized_inputs = std::vector<std::pair<long long, std::filesystem::path>>{};
+		const auto prefix = path.stem().string() + '.';
+		for (const auto& entry: std::filesystem::directory_iterator(sweep_dir))
+		{
+			// only <puzzle>.<size>.inp, other inputs like q01.big.inp are left alone
+			const auto stem = entry.path().stem().string();
+			if (entry.path().extension() != ".inp" || !stem.starts_with(prefix))
+				continue;
+			auto size = 0LL;
+			const auto [end, error] = std::from_chars(stem.data() + prefix.size(), stem.data() + stem.size(), size);
+			if (error == std::errc{} && end == stem.data() + stem.size())
+				sized_inputs.emplace_back(size, std::filesystem::absolute(entry.path()));
+		}
+		std::ranges::sort(sized_inputs);
+		for (const auto& [size, input]: sized_inputs)
+			add_job(name, input, [=, this, name = std::string{name}](std::ostream& out, std::ostream&, Statistics& statistics)
+			{
+				const auto result = run(func, name, input, out, statistics);
+				out << "Test " << name << " produced " << result << std::endl;
+			});
+	}
+
+	// with --serve, tests are not run but made available to the clients
+	void add_solver(auto func, std::string_view name)
+	{
+		solvers.try_emplace(std::string{name}, [func](std::istream& is)
+		{
+			auto answer = std::ostringstream{};
+			answer << func(is);
+			return answer.str();
+		});
+	}
+
+	// a test that used up its budget is reported, and fails the run
+	void add_job(std::string_view name, const std::filesystem::path& path, auto&& run)
+	{
+		const auto budget = budget_of(name);
+		jobs.push_back(Job{std::string{name}, path, [=, run = std::move(run), name = std::string{name}](std::ostream& out, std::ostream& err, Statistics& statistics)
+		{
+			try
+			{
+				run(out, err, statistics);
+			}
+			catch (const Cancelled& cancelled)
+			{
+				cancellation_deadline() = std::chrono::steady_clock::time_point::max();
+				statistics = Statistics::timeout(budget);
+				err << "Test " << name << " TIMEOUT after " << budget.count() << " ms with input " << path
+				    << ", progress " << std::lround(100 * cancelled.progress) << '%' << std::endl;
+			}
+		}, {}});
+	}
+
+	std::chrono::milliseconds budget_of(std::string_view name) const
+	{
+		if (budget_override)
+			return *budget_override;
+		const auto it = budgets.find(name);
+		return budget_scale * (it != budgets.end() ? it->second : default_budget);
+	}
+
+	void execute_parallel()
+	{
+		// longest first: the tests marked as slow, then by size of their input
+		auto cost = [&](const Job& job)
+		{
+			auto error = std::error_code{};
+			const auto size = std::filesystem::file_size("input" / job.path, error);
+			return std::make_pair(slow_tests.contains(job.name), error ? 0 : size);
+		};
+		auto order = std::vector<std::size_t>(jobs.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::ranges::stable_sort(order, std::greater<>{}, [&](auto index) { return cost(jobs[index]); });
+		using Output = std::pair<std::string, std::string>;
+		auto outputs = std::vector<std::future<Output>>(jobs.size());
+		auto pool = ThreadPool{num_threads};
+		for (const auto index: order)
+		{
+			auto task = std::packaged_task<Output()>([this, index]
+			{
+				auto out = std::ostringstream{};
+				auto err = std::ostringstream{};
+				jobs[index].run(out, err, jobs[index].statistics);
+				return Output{out.str(), err.str()};
+			});
+			outputs[index] = task.get_future();
+			pool.submit(std::move(task));
+		}
+		for (auto& output: outputs)
+		{
+			const auto [out, err] = output.get();
+			std::cout << out << std::flush;
+			std::cerr << err << std::flush;
+		}
+	}
+
+	auto run(auto&& func, std::string_view name, const std::filesystem::path& path, std::ostream& out, Statistics& statistics) const -> decltype(func(std::cin))
+	{
+		using ResultType = decltype(func(std::cin));
+		// the answers of both parts solved together are not cached
+		constexpr auto cacheable = std::is_integral_v<ResultType> || std::is_same_v<ResultType, std::string>;
+		const auto cache_key = (cache && cacheable) ? std::optional{ResultCache::Key{std::string{name}, load(path).hash}} : std::nullopt;
+		if constexpr (cacheable)
+			if (cache_key)
+				if (const auto entry = cache->find(*cache_key))
+				{
+					using namespace std::literals;
+					statistics = entry->statistics;
+					out << "Test " << name << " ran in " << std::setw(6) << std::lround(statistics.median/1us) << " us with input " << path << " (cached)" << std::endl;
+					if constexpr (std::is_integral_v<ResultType>)
+						return static_cast<ResultType>(std::stoll(entry->answer));
+					else
+						return ResultType{entry->answer};
+				}
+		auto result = ResultType{};
+		auto phases = std::vector<Phases>{};
+		auto allocations = AllocationCounters{};
+		auto perf_sample = PerfCounters::Sample{};
+		auto* const perf_counters = perf ? &PerfCounters::for_this_thread() : nullptr;
+		if (perf_counters && !perf_counters->available())
+			std::call_once(perf_warning, [&]
+			{
+				std::cerr << "Performance counters are not available (" << perf_counters->error() << "), check /proc/sys/kernel/perf_event_paranoid" << std::endl;
+			});
+		auto timed_run = [&]
+		{
+			auto duration = std::chrono::nanoseconds{};
+			with_input(path, [&](std::istream& is)
+			{
+				parse_end_time() = {};
+				const auto trace_zone = TraceZone{name};
+				// opened first, so growing the arena is not counted
+				const auto arena_scope = ArenaScope{};
+				const auto allocation_scope = AllocationScope{};
+				auto perf_scope = PerfScope{perf_counters};
+				const auto start = std::chrono::steady_clock::now();
+				cancellation_deadline() = start + budget_of(name);
+				result = func(is);
+				const auto end = std::chrono::steady_clock::now();
+				cancellation_deadline() = std::chrono::steady_clock::time_point::max();
+				perf_sample = perf_scope.stop();
+				allocations = allocation_scope.get();
+				duration = end - start;
+				if (const auto parsed = parse_end_time(); parsed >= start)
+					phases.push_back({parsed - start, end - parsed});
+			});
+			return duration;
+		};
 		using namespace std::literals;
-		std::cout << "Test " << name << " ran in " << std::setw(6) << (end - start)/1us << " us with input " << path << std::endl;
+		if (bench)
+		{
+			statistics = benchmark(bench_settings, timed_run);
+			out << "Test " << name << " bench: " << statistics << " with input " << path;
+			// the phases of the warmup runs are recorded as well
+			if (std::ssize(phases) > bench_settings.warmup)
+			{
+				phases.erase(phases.begin(), phases.begin() + bench_settings.warmup);
+				auto median = [&](auto member)
+				{
+					auto samples = std::vector<std::chrono::nanoseconds>{};
+					std::ranges::transform(phases, std::back_inserter(samples), member);
+					return std::round(Statistics::from(std::move(samples)).median.count() * 10) / 10;
+				};
+				out << ", median parse " << median(&Phases::parse) << " us, compute " << median(&Phases::compute) << " us";
+			}
+		}
+		else
+		{
+			const auto duration = timed_run();
+			statistics = Statistics::from({duration});
+			out << "Test " << name << " ran in " << std::setw(6) << duration/1us << " us with input " << path;
+			if (!phases.empty())
+				out << ", parse " << phases.back().parse/1us << " us, compute " << phases.back().compute/1us << " us";
+		}
+		if (preload)
+			out << ", io " << load(path).io_time/1us << " us";
+		out << ", " << allocations.allocations << " allocations of " << allocations.bytes << " bytes, peak " << allocations.peak_live_bytes << " bytes";
+		out << perf_sample;
+		out << std::endl;
+		if constexpr (cacheable)
+			if (cache_key)
+			{
+				auto answer = std::ostringstream{};
+				answer << result;
+				cache->store(*cache_key, {answer.str(), statistics});
+			}
 		return result;
 	}
+
+	// inputs are either read straight from disk, or from memory mapped files
+	// that are loaded once and shared by all tests and repetitions using them
+	void with_input(const std::filesystem::path& path, auto&& use) const
+	{
+		if (preload)
+		{
+			// solvers can get the memory back from the stream without copying, see InputBuffer
+			auto is = std::ispanstream{std::span<const char>{load(path).file.view()}};
+			use(is);
+		}
+		else
+		{
+			std::ifstream is("input" / path);
+			if (!is.good())
+				throw std::runtime_error("Could not find " + path.string());
+			use(is);
+		}
+	}
+
+	const Input& load(const std::filesystem::path& path) const
+	{
+		auto lock = std::scoped_lock{inputs_mutex};
+		if (const auto it = inputs.find(path); it != inputs.end())
+			return it->second;
+		const auto start = std::chrono::steady_clock::now();
+		auto file = MappedFile{"input" / path};
+		const auto end = std::chrono::steady_clock::now();
+		const auto hash = content_hash(file.view());
+		return inputs.emplace(path, Input{std::move(file), end - start, hash}).first->second;
+	}
+
+	bool bench = false;
+	bool preload = false;
+	bool perf = false;
+	mutable std::once_flag perf_warning;
+	bool parallel = false;
+	unsigned num_threads = ThreadPool::default_num_threads();
+	mutable std::mutex inputs_mutex;
+	mutable std::map<std::filesystem::path, Input> inputs;
+	// tests that are scheduled before all others when running in parallel
+	std::set<std::string, std::less<>> slow_tests;
+	std::set<std::pair<std::string, std::string>> solved_together;
+	// time per run of a test before it is cancelled
+	std::map<std::string, std::chrono::milliseconds, std::less<>> budgets;
+	std::chrono::milliseconds default_budget{10'000};
+	std::optional<std::chrono::milliseconds> budget_override;
+#ifdef __OPTIMIZE__
+	static constexpr auto budget_scale = 1;
+#else
+	// the budgets of the solvers are meant for optimised builds
+	static constexpr auto budget_scale = 10;
+#endif
+	std::vector<Job> jobs;
+	std::filesystem::path csv_path;
+	std::filesystem::path json_path;
+	std::filesystem::path baseline_path;
+	std::filesystem::path sweep_dir;
+	std::filesystem::path serve_path;
+	std::filesystem::path trace_path;
+	std::string batch_test;
+	std::filesystem::path batch_dir;
+	std::map<std::string, SolverServer::Solver, std::less<>> solvers;
+	bool use_cache = true;
+	std::filesystem::path cache_path = ".aoc_cache";
+	mutable std::optional<ResultCache> cache;
+	RegressionThreshold regression_threshold;
+	BenchmarkSettings bench_settings;
 	std::set<std::string, std::less<>> tests_to_run;
 	std::map<std::string, std::string, std::less<>> answers;
 };
@@ -0,0 +1,128 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+
+// Every worker has its own queue; tasks submitted from outside the pool are
+// distributed round-robin, tasks submitted by a worker go to its own queue.
+// An idle worker takes from the front of its own queue and steals from the
+// back of the others.
+class ThreadPool
+{
+public:
+	using Task = std::move_only_function<void()>;
+
+	explicit ThreadPool(unsigned num_threads = default_num_threads()) :
+		queues(std::max(num_threads, 1u))
+	{
+		for (auto i = 0u; i < queues.size(); ++i)
+			workers.emplace_back([this, i](std::stop_token stop) { work(stop, i); });
+	}
+
+	// waits until all submitted tasks are done
+	~ThreadPool()
+	{
+		for (auto& worker: workers)
+			worker.request_stop();
+		wake.notify_all();
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	void submit(Task task)
+	{
+		const auto index = (current_worker().pool == this) ? current_worker().index : next_queue++ % queues.size();
+		{
+			auto lock = std::scoped_lock{queues[index].mutex};
+			queues[index].tasks.push_back(std::move(task));
+		}
+		{
+			auto lock = std::scoped_lock{mutex};
+			++pending;
+		}
+		wake.notify_one();
+	}
+
+	auto size() const { return workers.size(); }
+
+	static unsigned default_num_threads() { return std::max(std::thread::hardware_concurrency(), 1u); }
+
+private:
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	struct Worker
+	{
+		const ThreadPool* pool = nullptr;
+		std::size_t index = 0;
+	};
+
+	static Worker& current_worker()
+	{
+		thread_local auto worker = Worker{};
+		return worker;
+	}
+
+	std::optional<Task> pop(std::size_t index)
+	{
+		for (auto i = 0u; i < queues.size(); ++i)
+		{
+			auto& queue = queues[(index + i) % queues.size()];
+			auto lock = std::scoped_lock{queue.mutex};
+			if (queue.tasks.empty())
+				continue;
+			auto task = std::optional<Task>{};
+			if (i == 0)
+			{
+				task = std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+			}
+			else
+			{
+				task = std::move(queue.tasks.back());
+				queue.tasks.pop_back();
+			}
+			return task;
+		}
+		return std::nullopt;
+	}
+
+	void work(std::stop_token stop, std::size_t index)
+	{
+		current_worker() = Worker{this, index};
+		while (true)
+		{
+			{
+				auto lock = std::unique_lock{mutex};
+				// keeps draining the queues after a stop is requested
+				if (!wake.wait(lock, stop, [&] { return pending > 0; }))
+					return;
+				// claims one of the queued tasks, it is in one of the queues
+				--pending;
+			}
+			auto task = pop(index);
+			while (!task)
+				task = pop(index);
+			(*task)();
+		}
+	}
+
+	std::vector<Queue> queues;
+	std::atomic<std::size_t> next_queue = 0;
+	std::mutex mutex;
+	std::condition_variable_any wake;
+	int pending = 0;
+	std::vector<std::jthread> workers;
+};